@@ -2,6 +2,7 @@
 #define BUBBLESORT_H
 
 #include "..\SortingCore.h"
+#include "..\ConstexprSort\ConstexprSort.h"
 
 ///=============================================================================
 /// Simple implementation of "Bubble Sort".
@@ -12,37 +13,97 @@
 /// BubbleSort<int, arrSize> bubbleSort(inputArray);
 /// bubbleSort.sort();
 /// bubbleSort.print();
+///
+/// Runtime-sized buffers are sorted in place, without a copy:
+/// BubbleSort<int> bubbleSort(buffer, bufferSize);
+///
+/// Tables known at compile time are sorted by the compiler:
+/// constexpr auto table = BubbleSort<int>::sorted(std::array<int, 4>{ 3, 1, 4, 2 });
 ///=============================================================================
-template <typename T, size_t SIZE>
+template <typename T, size_t SIZE = DYNAMIC_SIZE>
 class BubbleSort : public SortingCore<T, SIZE>
 {
 public:
-    ///=============================================================================
-    ///=============================================================================
-    BubbleSort(T* inputArray)
-        : SortingCore<T, SIZE>(inputArray)
-    {}
+    using SortingCore<T, SIZE>::SortingCore;
 
     ///=============================================================================
     ///=============================================================================
     ~BubbleSort() {}
 
     ///=============================================================================
+    /// @brief Sorts the array, dispatching once on the runtime order.
+    ///
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
     ///=============================================================================
     void sort(const SortOrder order = SortOrder::ASC)
     {
-        for (int i = 0; i < SIZE; ++i)
+        if (order == SortOrder::ASC)
+        {
+            sort<SortOrder::ASC>();
+        }
+        else
         {
-            for (int j = 1; j < (SIZE - i); ++j)
+            sort<SortOrder::DESC>();
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array in the order known at compile time.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    void sort()
+    {
+        sortBy(OrderedBefore<T, ORDER>());
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array by a user-supplied predicate over projected keys.
+    ///
+    /// @param Compare comp - returns true if the first key must be placed before
+    ///                       the second one (like std::less).
+    /// @param Projection proj - maps an element onto the key to compare.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Compare, typename Projection = IdentityProjection>
+    void sortBy(Compare comp,
+                Projection proj = Projection())
+    {
+        const auto before = makeProjectedBefore(comp, proj);
+        const std::size_t size = this->size();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            for (std::size_t j = 1; j < (size - i); ++j)
             {
-                if (this->compare(this->m_array[j - 1],
-                                  this->m_array[j], order))
+                if (before(this->m_array[j], this->m_array[j - 1]))
                 {
                     this->swap(this->m_array[j - 1], this->m_array[j]);
                 }
             }
         }
     }
+
+    ///=============================================================================
+    /// @brief Sorts a std::array, at compile time when used in a constant
+    ///        expression (see ConstexprSort.h).
+    ///
+    /// @param std::array<T, N> array - array to sort.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return std::array<T, N> - sorted array.
+    ///=============================================================================
+    template <std::size_t N>
+    static constexpr std::array<T, N> sorted(const std::array<T, N>& array,
+                                             const SortOrder order = SortOrder::ASC)
+    {
+        return order == SortOrder::ASC
+            ? SortingKernels::constexprBubbleSort(array, OrderedBefore<T, SortOrder::ASC>())
+            : SortingKernels::constexprBubbleSort(array, OrderedBefore<T, SortOrder::DESC>());
+    }
 };
 
 #endif // BUBBLESORT_H
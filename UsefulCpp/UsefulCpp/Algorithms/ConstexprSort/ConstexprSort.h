@@ -0,0 +1,242 @@
+#ifndef CONSTEXPRSORT_H
+#define CONSTEXPRSORT_H
+
+#include <array>
+#include <cstddef>
+
+#include "..\SortingCore.h"
+
+///=============================================================================
+/// Sorting kernels which can run at compile time: they take a std::array by
+/// value and return it sorted, so a lookup table can be sorted by the compiler
+/// and placed into read-only data, with no sorting at startup. The same
+/// functions work at runtime as well.
+///
+/// Needs C++17 (constexpr access to std::array elements). std::swap is not
+/// constexpr before C++20, so the kernels swap elements by hand.
+///
+/// Example of usage:
+/// constexpr std::array<int, 6> table =
+///     SortingKernels::constexprSort<SortOrder::ASC>(std::array<int, 6>{ 42, 7, 19, 3, 88, 1 });
+/// static_assert(table[0] == 1 && table[5] == 88, "sorted at compile time");
+///=============================================================================
+namespace SortingKernels
+{
+    ///=============================================================================
+    /// @brief Swaps two elements of the array.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, std::size_t N>
+    constexpr void constexprSwap(std::array<T, N>& array,
+                                 const std::size_t index1,
+                                 const std::size_t index2)
+    {
+        T tmp = array[index1];
+        array[index1] = array[index2];
+        array[index2] = tmp;
+    }
+
+    ///=============================================================================
+    /// @brief Insertion sort of [first, last).
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, std::size_t N, typename Compare>
+    constexpr void constexprInsertionSort(std::array<T, N>& array,
+                                          const std::size_t first,
+                                          const std::size_t last,
+                                          Compare comp)
+    {
+        for (std::size_t current = first + 1; current < last; ++current)
+        {
+            T value = array[current];
+            std::size_t hole = current;
+            while (hole > first && comp(value, array[hole - 1]))
+            {
+                array[hole] = array[hole - 1];
+                --hole;
+            }
+            array[hole] = value;
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Restores the heap property of the subtree with the given root. The
+    ///        heap is [first, first + size).
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, std::size_t N, typename Compare>
+    constexpr void constexprSiftDown(std::array<T, N>& array,
+                                     const std::size_t first,
+                                     std::size_t root,
+                                     const std::size_t size,
+                                     Compare comp)
+    {
+        for (std::size_t child = 2 * root + 1; child < size; child = 2 * root + 1)
+        {
+            // Picks the child which must be placed later
+            if (child + 1 < size && comp(array[first + child], array[first + child + 1]))
+            {
+                ++child;
+            }
+            if (!comp(array[first + root], array[first + child]))
+            {
+                return;
+            }
+            constexprSwap(array, first + root, first + child);
+            root = child;
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Heap sort of [first, last), the fallback of the introsort.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, std::size_t N, typename Compare>
+    constexpr void constexprHeapSort(std::array<T, N>& array,
+                                     const std::size_t first,
+                                     const std::size_t last,
+                                     Compare comp)
+    {
+        const std::size_t size = last - first;
+        for (std::size_t root = size / 2; root-- > 0; )
+        {
+            constexprSiftDown(array, first, root, size, comp);
+        }
+        for (std::size_t heapSize = size; heapSize-- > 1; )
+        {
+            constexprSwap(array, first, first + heapSize);
+            constexprSiftDown(array, first, 0, heapSize, comp);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Introsort of [first, last): median-of-three Hoare partition,
+    ///        insertion sort for small partitions, heap sort past the depth limit.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, std::size_t N, typename Compare>
+    constexpr void constexprIntroSort(std::array<T, N>& array,
+                                      std::size_t first,
+                                      std::size_t last,
+                                      std::size_t depthLimit,
+                                      Compare comp)
+    {
+        while (last - first > 16)
+        {
+            if (depthLimit == 0)
+            {
+                constexprHeapSort(array, first, last, comp);
+                return;
+            }
+            --depthLimit;
+
+            // Median of three goes to first, the other two bound the scans
+            const std::size_t middle = first + (last - first) / 2;
+            if (comp(array[middle], array[first]))    { constexprSwap(array, middle, first); }
+            if (comp(array[last - 1], array[middle])) { constexprSwap(array, last - 1, middle); }
+            if (comp(array[middle], array[first]))    { constexprSwap(array, middle, first); }
+            constexprSwap(array, first, middle);
+
+            const T pivot = array[first];
+            std::size_t left = first + 1;
+            std::size_t right = last;
+            for (;;)
+            {
+                while (comp(array[left], pivot))
+                {
+                    ++left;
+                }
+                --right;
+                while (comp(pivot, array[right]))
+                {
+                    --right;
+                }
+                if (left >= right)
+                {
+                    break;
+                }
+                constexprSwap(array, left, right);
+                ++left;
+            }
+
+            // Recurses into the smaller part, loops over the larger one
+            if (left - first < last - left)
+            {
+                constexprIntroSort(array, first, left, depthLimit, comp);
+                first = left;
+            }
+            else
+            {
+                constexprIntroSort(array, left, last, depthLimit, comp);
+                last = left;
+            }
+        }
+        constexprInsertionSort(array, first, last, comp);
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array with introsort.
+    ///
+    /// @param std::array<T, N> array - array to sort.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return std::array<T, N> - sorted array.
+    ///=============================================================================
+    template <typename T, std::size_t N, typename Compare>
+    constexpr std::array<T, N> constexprSort(std::array<T, N> array,
+                                             Compare comp)
+    {
+        std::size_t depth = 0;
+        for (std::size_t size = N; size > 1; size >>= 1)
+        {
+            ++depth;
+        }
+        constexprIntroSort(array, 0, N, 2 * depth, comp);
+        return array;
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array with introsort in the order known at compile time.
+    ///
+    /// @param std::array<T, N> array - array to sort.
+    ///
+    /// @return std::array<T, N> - sorted array.
+    ///=============================================================================
+    template <SortOrder ORDER, typename T, std::size_t N>
+    constexpr std::array<T, N> constexprSort(std::array<T, N> array)
+    {
+        return constexprSort(array, OrderedBefore<T, ORDER>());
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array with bubble sort.
+    ///
+    /// @param std::array<T, N> array - array to sort.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return std::array<T, N> - sorted array.
+    ///=============================================================================
+    template <typename T, std::size_t N, typename Compare>
+    constexpr std::array<T, N> constexprBubbleSort(std::array<T, N> array,
+                                                   Compare comp)
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 1; j < N - i; ++j)
+            {
+                if (comp(array[j], array[j - 1]))
+                {
+                    constexprSwap(array, j - 1, j);
+                }
+            }
+        }
+        return array;
+    }
+}
+
+#endif // CONSTEXPRSORT_H
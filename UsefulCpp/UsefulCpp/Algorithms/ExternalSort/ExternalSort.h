@@ -0,0 +1,563 @@
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "..\SortingCore.h"
+#include "..\QuickSort\QuickSort.h"
+#include "..\Parallel\WorkStealingPool.h"
+#include "..\..\IO\File.h"
+#include "..\..\IO\MappedFile.h"
+
+///=============================================================================
+/// Settings of ExternalSort.
+///=============================================================================
+struct ExternalSortConfig
+{
+    // Upper bound of the buffers allocated by the sort, in bytes
+    std::size_t memoryBudget = std::size_t(256) << 20;
+
+    // Directory of the temporary run files
+    std::string tempDirectory = ".";
+
+    // Threads sorting a run, including the calling one (0 - all hardware threads)
+    std::size_t threadCount = 0;
+
+    // Writes runs and output with O_DIRECT where supported
+    bool directIo = false;
+
+    SortOrder order = SortOrder::ASC;
+};
+
+///=============================================================================
+/// Tournament tree of losers over k sorted sources. The root holds the index
+/// of the current winner; replacing it costs exactly log2(k) comparisons, one
+/// per level, against the stored losers.
+///=============================================================================
+template <typename T, typename Compare>
+class LoserTree
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const std::size_t sourceCount - number of sources (k > 0).
+    /// @param Compare comp - "placed before" predicate.
+    ///=============================================================================
+    LoserTree(const std::size_t sourceCount,
+              Compare comp)
+        : m_comp(comp)
+        , m_keys(sourceCount)
+        , m_exhausted(sourceCount, true)
+        , m_tree(sourceCount, sourceCount)
+    {}
+
+    ///=============================================================================
+    /// @brief Sets the first key of a source before build(). Sources which are
+    ///        not set are treated as empty.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void setKey(const std::size_t source,
+                const T key)
+    {
+        m_keys[source] = key;
+        m_exhausted[source] = false;
+    }
+
+    ///=============================================================================
+    /// @brief Plays the initial tournament.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void build()
+    {
+        const std::size_t count = m_keys.size();
+        std::fill(m_tree.begin(), m_tree.end(), count);
+        for (std::size_t source = 0; source < count; ++source)
+        {
+            std::size_t winner = source;
+            std::size_t node = (source + count) / 2;
+            while (node > 0)
+            {
+                if (m_tree[node] == count)
+                {
+                    // First player of that match waits for its opponent
+                    m_tree[node] = winner;
+                    winner = count;
+                    break;
+                }
+                if (beats(m_tree[node], winner))
+                {
+                    std::swap(m_tree[node], winner);
+                }
+                node /= 2;
+            }
+            if (winner != count)
+            {
+                m_tree[0] = winner;
+            }
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Checks whether all the sources are exhausted.
+    ///=============================================================================
+    bool empty() const { return m_exhausted[m_tree[0]]; }
+
+    ///=============================================================================
+    /// @brief Gets the source of the current winner.
+    ///=============================================================================
+    std::size_t winner() const { return m_tree[0]; }
+
+    ///=============================================================================
+    /// @brief Gets the current winner key.
+    ///=============================================================================
+    T top() const { return m_keys[m_tree[0]]; }
+
+    ///=============================================================================
+    /// @brief Replaces the winner with the next key of its source and replays
+    ///        the path to the root.
+    ///
+    /// @param const bool hasNext - false if the winner's source is exhausted.
+    /// @param const T next - next key of the winner's source.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void replaceTop(const bool hasNext,
+                    const T next)
+    {
+        std::size_t winner = m_tree[0];
+        m_keys[winner] = next;
+        m_exhausted[winner] = !hasNext;
+        for (std::size_t node = (winner + m_keys.size()) / 2; node > 0; node /= 2)
+        {
+            if (beats(m_tree[node], winner))
+            {
+                std::swap(m_tree[node], winner);
+            }
+        }
+        m_tree[0] = winner;
+    }
+
+private:
+    ///=============================================================================
+    /// @brief Checks whether source a wins over source b. Ties go to the lower
+    ///        index, which keeps the merge stable.
+    ///=============================================================================
+    bool beats(const std::size_t a,
+               const std::size_t b) const
+    {
+        if (m_exhausted[a] || m_exhausted[b])
+        {
+            return !m_exhausted[a];
+        }
+        if (m_comp(m_keys[a], m_keys[b]))
+        {
+            return true;
+        }
+        return !m_comp(m_keys[b], m_keys[a]) && a < b;
+    }
+
+    Compare           m_comp;
+    std::vector<T>    m_keys;
+    std::vector<bool> m_exhausted;
+    std::vector<std::size_t> m_tree;
+};
+
+///=============================================================================
+/// External-memory merge sort of a binary file of integral keys (native byte
+/// order) which may be much larger than RAM.
+///
+/// 1. The input is memory-mapped and cut into chunks of the memory budget.
+///    Every chunk is sorted by QuickSort (block partition) on all threads of a
+///    work-stealing pool and spilled to a temporary run file.
+/// 2. Runs are merged by a loser tree with large sequential buffered reads and
+///    writes (optionally O_DIRECT). When there are too many runs for the
+///    buffers to stay large, groups of runs are merged into longer runs first.
+///
+/// Example of usage:
+/// ExternalSortConfig config;
+/// config.memoryBudget = std::size_t(4) << 30;  // 4 GB
+/// config.tempDirectory = "/mnt/scratch";
+/// ExternalSort<std::uint64_t> externalSort(config);
+/// externalSort.sort("ids.bin", "ids.sorted.bin");
+///=============================================================================
+template <typename T>
+class ExternalSort
+{
+    static_assert(std::is_integral<T>::value, "Integral value is required.");
+
+public:
+    // Smallest buffer of a run during the merge, smaller buffers mean seeks
+    static constexpr std::size_t MIN_MERGE_BUFFER = std::size_t(1) << 20;
+
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const ExternalSortConfig& config - settings.
+    ///=============================================================================
+    explicit ExternalSort(const ExternalSortConfig& config = ExternalSortConfig())
+        : m_config(config)
+    {}
+
+    ///=============================================================================
+    /// @brief Sorts the input file into the output file. Temporary run files are
+    ///        removed before returning, also on errors.
+    ///
+    /// @param const std::string& inputPath - file of keys.
+    /// @param const std::string& outputPath - sorted file of keys.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void sort(const std::string& inputPath,
+              const std::string& outputPath)
+    {
+        TempFiles runs;
+        createRuns(inputPath, outputPath, runs);
+        if (runs.paths.empty())
+        {
+            return;
+        }
+
+        const std::size_t fanIn = maxFanIn();
+        while (runs.paths.size() > fanIn)
+        {
+            // Intermediate pass: groups of fanIn runs become single longer runs
+            TempFiles merged;
+            for (std::size_t first = 0; first < runs.paths.size(); first += fanIn)
+            {
+                const std::size_t last = std::min(first + fanIn, runs.paths.size());
+                merged.paths.push_back(makeTempPath());
+                mergeRuns(runs.paths.data() + first, last - first, merged.paths.back());
+            }
+            std::swap(runs.paths, merged.paths);
+        }
+        mergeRuns(runs.paths.data(), runs.paths.size(), outputPath);
+    }
+
+private:
+    ///=============================================================================
+    /// Removes the listed files on destruction.
+    ///=============================================================================
+    struct TempFiles
+    {
+        std::vector<std::string> paths;
+
+        ~TempFiles()
+        {
+            for (const auto& path : paths)
+            {
+                std::remove(path.c_str());
+            }
+        }
+    };
+
+    ///=============================================================================
+    /// Heap buffer aligned for direct I/O.
+    ///=============================================================================
+    class AlignedBuffer
+    {
+    public:
+        explicit AlignedBuffer(const std::size_t bytes)
+            : m_storage(new unsigned char[bytes + File::DIRECT_IO_ALIGNMENT])
+            , m_size(bytes)
+        {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_storage.get());
+            const std::uintptr_t alignment = File::DIRECT_IO_ALIGNMENT;
+            m_data = m_storage.get() + (alignment - address % alignment) % alignment;
+        }
+
+        unsigned char* data() noexcept { return m_data; }
+        std::size_t size() const noexcept { return m_size; }
+
+    private:
+        std::unique_ptr<unsigned char[]> m_storage;
+        unsigned char*                   m_data;
+        std::size_t                      m_size;
+    };
+
+    ///=============================================================================
+    /// Sequential writer of keys with a large buffer. Full buffers are written
+    /// directly when the file is in the direct I/O mode; the unaligned tail is
+    /// written after switching back to buffered I/O.
+    ///=============================================================================
+    class RunWriter
+    {
+    public:
+        RunWriter(const std::string& path,
+                  const std::size_t bufferBytes,
+                  const bool directIo)
+            : m_file(path, File::Mode::WRITE, directIo)
+            , m_buffer(alignDown(bufferBytes))
+            , m_used(0)
+        {}
+
+        void write(const T* keys,
+                   std::size_t count)
+        {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(keys);
+            std::size_t remaining = count * sizeof(T);
+            while (remaining > 0)
+            {
+                const std::size_t chunk = std::min(remaining, m_buffer.size() - m_used);
+                std::memcpy(m_buffer.data() + m_used, bytes, chunk);
+                m_used += chunk;
+                bytes += chunk;
+                remaining -= chunk;
+                if (m_used == m_buffer.size())
+                {
+                    m_file.write(m_buffer.data(), m_used);
+                    m_used = 0;
+                }
+            }
+        }
+
+        void push(const T key)
+        {
+            if (m_used + sizeof(T) > m_buffer.size())
+            {
+                write(&key, 1);
+                return;
+            }
+            std::memcpy(m_buffer.data() + m_used, &key, sizeof(T));
+            m_used += sizeof(T);
+        }
+
+        void finish()
+        {
+            if (m_used > 0)
+            {
+                m_file.disableDirectIo();
+                m_file.write(m_buffer.data(), m_used);
+                m_used = 0;
+            }
+            m_file.close();
+        }
+
+    private:
+        static std::size_t alignDown(const std::size_t bytes)
+        {
+            const std::size_t alignment = File::DIRECT_IO_ALIGNMENT;
+            return std::max(alignment, bytes / alignment * alignment);
+        }
+
+        File          m_file;
+        AlignedBuffer m_buffer;
+        std::size_t   m_used;
+    };
+
+    ///=============================================================================
+    /// Sequential reader of a run with a large buffer.
+    ///=============================================================================
+    class RunReader
+    {
+    public:
+        RunReader(const std::string& path,
+                  const std::size_t bufferBytes)
+            : m_file(path, File::Mode::READ)
+            , m_buffer(std::max<std::size_t>(1, bufferBytes / sizeof(T)))
+            , m_position(0)
+            , m_count(0)
+        {}
+
+        bool next(T& key)
+        {
+            if (m_position == m_count)
+            {
+                m_count = m_file.read(m_buffer.data(), m_buffer.size() * sizeof(T)) / sizeof(T);
+                m_position = 0;
+                if (m_count == 0)
+                {
+                    return false;
+                }
+            }
+            key = m_buffer[m_position++];
+            return true;
+        }
+
+    private:
+        File           m_file;
+        std::vector<T> m_buffer;
+        std::size_t    m_position;
+        std::size_t    m_count;
+    };
+
+    ///=============================================================================
+    /// @brief Run phase: sorts chunks of the memory-mapped input on all threads.
+    ///        A single chunk is written straight to the output file.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void createRuns(const std::string& inputPath,
+                    const std::string& outputPath,
+                    TempFiles& runs)
+    {
+        MappedFile input(inputPath);
+        if (input.size() % sizeof(T) != 0)
+        {
+            throw std::runtime_error(inputPath + " is not a whole number of keys");
+        }
+        input.adviseSequential();
+
+        const std::size_t count = input.size() / sizeof(T);
+        const std::size_t runCapacity = std::max<std::size_t>(1, m_config.memoryBudget / sizeof(T));
+        if (count <= runCapacity)
+        {
+            // Fits into memory: no runs, no merge
+            sortChunk(input, 0, count, outputPath);
+            return;
+        }
+
+        WorkStealingPool pool(m_config.threadCount == 0 ? WorkStealingPool::defaultWorkerCount()
+                                                        : m_config.threadCount - 1);
+        AlignedBuffer chunk(runCapacity * sizeof(T));
+        for (std::size_t first = 0; first < count; first += runCapacity)
+        {
+            runs.paths.push_back(makeTempPath());
+            sortChunk(input, first, std::min(runCapacity, count - first), runs.paths.back(),
+                      &pool, &chunk);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Copies a chunk of the input into memory, sorts it and writes it
+    ///        into the file straight from the chunk buffer.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void sortChunk(const MappedFile& input,
+                   const std::size_t first,
+                   const std::size_t count,
+                   const std::string& path,
+                   WorkStealingPool* pool = nullptr,
+                   AlignedBuffer* chunk = nullptr)
+    {
+        std::unique_ptr<WorkStealingPool> ownPool;
+        std::unique_ptr<AlignedBuffer> ownChunk;
+        if (pool == nullptr)
+        {
+            ownPool.reset(new WorkStealingPool(m_config.threadCount == 0
+                ? WorkStealingPool::defaultWorkerCount() : m_config.threadCount - 1));
+            pool = ownPool.get();
+        }
+        if (chunk == nullptr)
+        {
+            ownChunk.reset(new AlignedBuffer(count * sizeof(T)));
+            chunk = ownChunk.get();
+        }
+
+        const std::size_t bytes = count * sizeof(T);
+        T* keys = reinterpret_cast<T*>(chunk->data());
+        if (bytes > 0)
+        {
+            std::memcpy(keys, input.data() + first * sizeof(T), bytes);
+            input.adviseDone(first * sizeof(T), bytes);
+        }
+
+        QuickSort<T> quickSort(keys, count);
+        quickSort.setPartitionScheme(PartitionScheme::BLOCK);
+        quickSort.parallelSort(*pool, m_config.order);
+
+        // Aligned body goes directly (if enabled), the tail through the page cache
+        File file(path, File::Mode::WRITE, m_config.directIo);
+        const std::size_t body = file.isDirect()
+            ? bytes / File::DIRECT_IO_ALIGNMENT * File::DIRECT_IO_ALIGNMENT
+            : bytes;
+        file.write(chunk->data(), body);
+        file.disableDirectIo();
+        file.write(chunk->data() + body, bytes - body);
+    }
+
+    ///=============================================================================
+    /// @brief Merges sorted runs into one file with a loser tree.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void mergeRuns(const std::string* paths,
+                   const std::size_t count,
+                   const std::string& outputPath)
+    {
+        // Budget is shared by the readers and the writer
+        const std::size_t bufferBytes = m_config.memoryBudget / (count + 1);
+
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            readers.emplace_back(new RunReader(paths[i], bufferBytes));
+        }
+        RunWriter writer(outputPath, bufferBytes, m_config.directIo);
+
+        if (m_config.order == SortOrder::ASC)
+        {
+            mergeRuns(readers, writer, OrderedBefore<T, SortOrder::ASC>());
+        }
+        else
+        {
+            mergeRuns(readers, writer, OrderedBefore<T, SortOrder::DESC>());
+        }
+        writer.finish();
+    }
+
+    ///=============================================================================
+    /// @brief Merge loop for the order known at compile time.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Compare>
+    void mergeRuns(std::vector<std::unique_ptr<RunReader>>& readers,
+                   RunWriter& writer,
+                   Compare comp)
+    {
+        LoserTree<T, Compare> tree(readers.size(), comp);
+        T key{};
+        for (std::size_t i = 0; i < readers.size(); ++i)
+        {
+            if (readers[i]->next(key))
+            {
+                tree.setKey(i, key);
+            }
+        }
+        tree.build();
+
+        while (!tree.empty())
+        {
+            writer.push(tree.top());
+            const bool hasNext = readers[tree.winner()]->next(key);
+            tree.replaceTop(hasNext, key);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Largest number of runs merged at once, so that every buffer is at
+    ///        least MIN_MERGE_BUFFER bytes.
+    ///=============================================================================
+    std::size_t maxFanIn() const
+    {
+        return std::max<std::size_t>(2, m_config.memoryBudget / MIN_MERGE_BUFFER - 1);
+    }
+
+    ///=============================================================================
+    /// @brief Unique path of a temporary run file.
+    ///=============================================================================
+    std::string makeTempPath() const
+    {
+        static std::atomic<std::uint64_t> counter{ 0 };
+        const auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+        return m_config.tempDirectory + "/extsort_" +
+               std::to_string(static_cast<unsigned long long>(ticks)) + "_" +
+               std::to_string(static_cast<unsigned long long>(counter.fetch_add(1))) + ".run";
+    }
+
+    ExternalSortConfig m_config;
+};
+
+#endif // EXTERNALSORT_H
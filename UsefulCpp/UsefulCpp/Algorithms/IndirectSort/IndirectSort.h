@@ -0,0 +1,256 @@
+#ifndef INDIRECTSORT_H
+#define INDIRECTSORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "..\SortingCore.h"
+#include "..\QuickSort\IntroSort.h"
+
+///=============================================================================
+/// Indirect sorting of records by an integral key. Large records are never
+/// moved by the sort itself: compact (key, index) pairs are sorted instead and
+/// the records are permuted once at the end, so every record is moved at most
+/// once plus once per cycle of the permutation.
+///
+/// argsort() returns the permutation only, sortByKey() also applies it, and
+/// applyPermutation() reorders any range by a given permutation in place.
+/// Both sorts are stable: records with equal keys keep their relative order.
+///
+/// Example of usage:
+/// struct Order { std::uint64_t id; char payload[120]; };
+/// std::vector<Order> orders = loadOrders();
+/// const auto byId = [](const Order& order) { return order.id; };
+/// std::vector<std::size_t> ranks = SortingKernels::argsort(orders.data(),
+///                                                          orders.data() + orders.size(),
+///                                                          byId);
+/// SortingKernels::sortByKey(orders.data(), orders.data() + orders.size(),
+///                           byId, SortOrder::DESC);
+///=============================================================================
+namespace SortingKernels
+{
+    ///=============================================================================
+    /// Key of a record together with the record's position in the input.
+    ///=============================================================================
+    template <typename Key, typename Index>
+    struct KeyIndex
+    {
+        Key   key;
+        Index index;
+    };
+
+    ///=============================================================================
+    /// "Placed before" predicate of KeyIndex pairs. Equal keys are ordered by
+    /// index, which makes the sort stable whatever the engine is.
+    ///=============================================================================
+    template <typename Key, typename Index, SortOrder ORDER>
+    struct KeyIndexBefore
+    {
+        bool operator()(const KeyIndex<Key, Index>& lhs,
+                        const KeyIndex<Key, Index>& rhs) const noexcept
+        {
+            if (lhs.key != rhs.key)
+            {
+                return OrderedBefore<Key, ORDER>()(lhs.key, rhs.key);
+            }
+            return lhs.index < rhs.index;
+        }
+    };
+
+    ///=============================================================================
+    /// @brief Reorders [first, last) in place so that the element at position i
+    ///        is the one which was at position permutation[i] (a gather). Each
+    ///        cycle of the permutation is walked once with a single temporary.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Index* permutation - permutation of [0, last - first). It is reset
+    ///                             to the identity on return.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Index>
+    void applyPermutation(T* first,
+                          T* last,
+                          Index* permutation)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        for (std::size_t start = 0; start < size; ++start)
+        {
+            if (static_cast<std::size_t>(permutation[start]) == start)
+            {
+                continue;
+            }
+
+            // Walks the cycle, pulling every element from its source position
+            T value{ std::move(first[start]) };
+            std::size_t hole = start;
+            for (;;)
+            {
+                const std::size_t source = static_cast<std::size_t>(permutation[hole]);
+                permutation[hole] = static_cast<Index>(hole);
+                if (source == start)
+                {
+                    break;
+                }
+                first[hole] = std::move(first[source]);
+                hole = source;
+            }
+            first[hole] = std::move(value);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Reorders [first, last) in place by a permutation which must be kept.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param const std::vector<Index>& permutation - permutation of [0, last - first).
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Index>
+    void applyPermutation(T* first,
+                          T* last,
+                          const std::vector<Index>& permutation)
+    {
+        std::vector<Index> scratch(permutation);
+        applyPermutation(first, last, scratch.data());
+    }
+
+    ///=============================================================================
+    /// @brief Sorts (key, index) pairs of the records.
+    ///
+    /// @return std::vector<KeyIndex<Key, Index>> - pairs in sorted order.
+    ///=============================================================================
+    template <typename Index, SortOrder ORDER, typename Record, typename KeyOf>
+    auto sortedKeyIndices(const Record* first,
+                          const Record* last,
+                          KeyOf keyOf)
+        -> std::vector<KeyIndex<typename std::decay<decltype(keyOf(*first))>::type, Index>>
+    {
+        using Key = typename std::decay<decltype(keyOf(*first))>::type;
+        static_assert(std::is_integral<Key>::value, "Integral key is required.");
+
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        std::vector<KeyIndex<Key, Index>> pairs(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            pairs[i].key = keyOf(first[i]);
+            pairs[i].index = static_cast<Index>(i);
+        }
+        introSort<PartitionScheme::BLOCK>(pairs.data(), pairs.data() + size,
+                                          KeyIndexBefore<Key, Index, ORDER>());
+        return pairs;
+    }
+
+    ///=============================================================================
+    /// @brief Stable argsort: positions of the records in sorted order.
+    ///
+    /// @param const Record* first - beginning of the records.
+    /// @param const Record* last - end of the records.
+    /// @param KeyOf keyOf - maps a record onto its integral key.
+    ///
+    /// @return std::vector<std::size_t> - result[i] is the position of the record
+    ///                                    which is i-th in sorted order.
+    ///=============================================================================
+    template <SortOrder ORDER, typename Record, typename KeyOf>
+    std::vector<std::size_t> argsort(const Record* first,
+                                     const Record* last,
+                                     KeyOf keyOf)
+    {
+        const auto pairs = sortedKeyIndices<std::size_t, ORDER>(first, last, keyOf);
+        std::vector<std::size_t> permutation(pairs.size());
+        for (std::size_t i = 0; i < pairs.size(); ++i)
+        {
+            permutation[i] = pairs[i].index;
+        }
+        return permutation;
+    }
+
+    ///=============================================================================
+    /// @brief Stable argsort, dispatching once on the runtime order.
+    ///
+    /// @param const Record* first - beginning of the records.
+    /// @param const Record* last - end of the records.
+    /// @param KeyOf keyOf - maps a record onto its integral key.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return std::vector<std::size_t> - positions of the records in sorted order.
+    ///=============================================================================
+    template <typename Record, typename KeyOf>
+    std::vector<std::size_t> argsort(const Record* first,
+                                     const Record* last,
+                                     KeyOf keyOf,
+                                     const SortOrder order = SortOrder::ASC)
+    {
+        return order == SortOrder::ASC ? argsort<SortOrder::ASC>(first, last, keyOf)
+                                       : argsort<SortOrder::DESC>(first, last, keyOf);
+    }
+
+    ///=============================================================================
+    /// @brief Stable key+payload sort of the records. Pairs with 32-bit indices
+    ///        are used when the number of records allows, which keeps a pair of
+    ///        a 32-bit key within 8 bytes.
+    ///
+    /// @param Record* first - beginning of the records.
+    /// @param Record* last - end of the records.
+    /// @param KeyOf keyOf - maps a record onto its integral key.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER, typename Record, typename KeyOf>
+    void sortByKey(Record* first,
+                   Record* last,
+                   KeyOf keyOf)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size <= std::numeric_limits<std::uint32_t>::max())
+        {
+            const auto pairs = sortedKeyIndices<std::uint32_t, ORDER>(first, last, keyOf);
+            std::vector<std::uint32_t> permutation(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                permutation[i] = pairs[i].index;
+            }
+            applyPermutation(first, last, permutation.data());
+        }
+        else
+        {
+            std::vector<std::size_t> permutation = argsort<ORDER>(first, last, keyOf);
+            applyPermutation(first, last, permutation.data());
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Stable key+payload sort, dispatching once on the runtime order.
+    ///
+    /// @param Record* first - beginning of the records.
+    /// @param Record* last - end of the records.
+    /// @param KeyOf keyOf - maps a record onto its integral key.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Record, typename KeyOf>
+    void sortByKey(Record* first,
+                   Record* last,
+                   KeyOf keyOf,
+                   const SortOrder order = SortOrder::ASC)
+    {
+        if (order == SortOrder::ASC)
+        {
+            sortByKey<SortOrder::ASC>(first, last, keyOf);
+        }
+        else
+        {
+            sortByKey<SortOrder::DESC>(first, last, keyOf);
+        }
+    }
+}
+
+#endif // INDIRECTSORT_H
@@ -0,0 +1,246 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+///=============================================================================
+/// Thread pool with one task deque per worker. A worker pushes and pops its own
+/// tasks at the back (LIFO, cache-friendly) and, when it runs dry, steals the
+/// oldest task from the front of another worker's deque. Tasks submitted from
+/// threads outside of the pool go to a separate injection deque.
+///
+/// The pool does not track task completion itself. Callers count their tasks
+/// and use helpWhile() to wait: the waiting thread executes pending tasks
+/// instead of blocking, so a pool of N workers keeps N + 1 threads busy.
+///
+/// Example of usage:
+/// WorkStealingPool pool(3);
+/// std::atomic<std::size_t> pending{ 2 };
+/// pool.submit([&pending] { work(); pending.fetch_sub(1, std::memory_order_acq_rel); });
+/// pool.submit([&pending] { work(); pending.fetch_sub(1, std::memory_order_acq_rel); });
+/// pool.helpWhile([&pending] { return pending.load(std::memory_order_acquire) != 0; });
+///=============================================================================
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    ///=============================================================================
+    /// @brief Constructor. Starts the worker threads.
+    ///
+    /// @param const std::size_t workerCount - number of worker threads, may be 0
+    ///                                        (then tasks run in helpWhile() only).
+    ///=============================================================================
+    explicit WorkStealingPool(const std::size_t workerCount = defaultWorkerCount())
+        : m_queuedTasks(0)
+        , m_stop(false)
+    {
+        // The last queue is the injection queue of the external threads
+        for (std::size_t i = 0; i <= workerCount; ++i)
+        {
+            m_queues.emplace_back(new WorkQueue);
+        }
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Destructor. Stops and joins the workers. Tasks which were not
+    ///        started yet are dropped.
+    ///=============================================================================
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_wakeUp.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Forbids copying and moving: workers hold a pointer to the pool
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ///=============================================================================
+    /// @brief Default number of workers: one less than the hardware threads, as
+    ///        the waiting thread takes part in the work too.
+    ///
+    /// @return std::size_t - number of workers.
+    ///=============================================================================
+    static std::size_t defaultWorkerCount()
+    {
+        const std::size_t hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    ///=============================================================================
+    /// @brief Gets number of worker threads.
+    ///
+    /// @return std::size_t - number of workers.
+    ///=============================================================================
+    std::size_t workerCount() const noexcept { return m_threads.size(); }
+
+    ///=============================================================================
+    /// @brief Schedules a task. A worker puts it into its own deque, any other
+    ///        thread into the injection deque.
+    ///
+    /// @param Task task - task to execute.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void submit(Task task)
+    {
+        WorkQueue& queue = *m_queues[localQueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            // Taken to not lose a wake-up of a worker which is about to sleep
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            ++m_queuedTasks;
+        }
+        m_wakeUp.notify_one();
+    }
+
+    ///=============================================================================
+    /// @brief Executes pending tasks on the calling thread while busy() returns
+    ///        true.
+    ///
+    /// @param Predicate busy - waiting condition.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Predicate>
+    void helpWhile(Predicate busy)
+    {
+        const std::size_t index = localQueueIndex();
+        Task task;
+        while (busy())
+        {
+            if (tryTake(index, task))
+            {
+                task();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct WorkerIdentity
+    {
+        const WorkStealingPool* pool;
+        std::size_t             index;
+    };
+
+    ///=============================================================================
+    /// @brief Identity of the calling thread, set for the workers only.
+    ///=============================================================================
+    static WorkerIdentity& identity()
+    {
+        static thread_local WorkerIdentity workerIdentity{ nullptr, 0 };
+        return workerIdentity;
+    }
+
+    ///=============================================================================
+    /// @brief Own queue of the worker, or the injection queue for other threads.
+    ///=============================================================================
+    std::size_t localQueueIndex() const
+    {
+        const WorkerIdentity& self = identity();
+        return self.pool == this ? self.index : m_queues.size() - 1;
+    }
+
+    ///=============================================================================
+    /// @brief Pops the newest task of the own queue or steals the oldest task of
+    ///        another one.
+    ///
+    /// @return true if a task was taken.
+    ///=============================================================================
+    bool tryTake(const std::size_t index,
+                 Task& task)
+    {
+        const std::size_t queueCount = m_queues.size();
+        for (std::size_t i = 0; i < queueCount; ++i)
+        {
+            const std::size_t victim = (index + i) % queueCount;
+            WorkQueue& queue = *m_queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+            {
+                continue;
+            }
+            if (victim == index)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    ///=============================================================================
+    /// @brief Main loop of a worker thread.
+    ///=============================================================================
+    void workerLoop(const std::size_t index)
+    {
+        identity() = WorkerIdentity{ this, index };
+
+        Task task;
+        while (true)
+        {
+            if (tryTake(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.wait(lock, [this] { return m_stop || m_queuedTasks.load() != 0; });
+            if (m_stop)
+            {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread>                m_threads;
+    std::mutex                              m_sleepMutex;
+    std::condition_variable                 m_wakeUp;
+    std::atomic<std::size_t>                m_queuedTasks;
+    bool                                    m_stop;
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,234 @@
+#ifndef INTROSORT_H
+#define INTROSORT_H
+
+#include <cstddef>
+#include <utility>
+
+#include "Partition.h"
+
+///=============================================================================
+/// Building blocks of "Introsort" (introspective sort): quick sort with a
+/// median-of-three / ninther pivot, insertion sort for small partitions and a
+/// heap sort fallback once the recursion gets too deep. The partition scheme
+/// (see Partition.h) is a template parameter.
+///
+/// All kernels work over a contiguous range [first, last) and take a predicate
+/// comp(lhs, rhs) which returns true if lhs must be placed before rhs (strict
+/// weak ordering, like std::less).
+///
+/// Guarantees: worst-case O(n log n) comparisons, O(log n) stack depth.
+///=============================================================================
+namespace SortingKernels
+{
+    // Partitions which are not larger than that are finished by insertion sort
+    constexpr std::size_t INSERTION_SORT_THRESHOLD = 16;
+
+    ///=============================================================================
+    /// @brief Straight insertion sort. Fast on small and nearly sorted ranges.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void insertionSort(T* first,
+                       T* last,
+                       Compare comp)
+    {
+        if (first == last)
+        {
+            return;
+        }
+
+        for (T* current = first + 1; current < last; ++current)
+        {
+            T value{ std::move(*current) };
+            T* hole = current;
+            while (hole != first && comp(value, *(hole - 1)))
+            {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            }
+            *hole = std::move(value);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Restores the heap property of the subtree with the given root.
+    ///
+    /// @param T* first - beginning of the heap.
+    /// @param std::size_t root - index of the subtree root.
+    /// @param const std::size_t size - number of elements in the heap.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void siftDown(T* first,
+                  std::size_t root,
+                  const std::size_t size,
+                  Compare comp)
+    {
+        T value{ std::move(first[root]) };
+        std::size_t child = 2 * root + 1;
+        while (child < size)
+        {
+            // Picks the child which must be placed later
+            if (child + 1 < size && comp(first[child], first[child + 1]))
+            {
+                ++child;
+            }
+            if (!comp(value, first[child]))
+            {
+                break;
+            }
+            first[root] = std::move(first[child]);
+            root = child;
+            child = 2 * root + 1;
+        }
+        first[root] = std::move(value);
+    }
+
+    ///=============================================================================
+    /// @brief Heap sort. O(n log n) in the worst case, no additional memory.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void heapSort(T* first,
+                  T* last,
+                  Compare comp)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size < 2)
+        {
+            return;
+        }
+
+        for (std::size_t root = size / 2; root-- > 0; )
+        {
+            siftDown(first, root, size, comp);
+        }
+        for (std::size_t heapSize = size - 1; heapSize > 0; --heapSize)
+        {
+            swapElements(first[0], first[heapSize]);
+            siftDown(first, 0, heapSize, comp);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Depth limit of the quick sort phase: 2 * floor(log2(size)).
+    ///
+    /// @param std::size_t size - number of elements.
+    ///
+    /// @return std::size_t - depth limit.
+    ///=============================================================================
+    inline std::size_t introSortDepthLimit(std::size_t size)
+    {
+        std::size_t depth = 0;
+        for (; size > 1; size >>= 1)
+        {
+            ++depth;
+        }
+        return 2 * depth;
+    }
+
+    ///=============================================================================
+    /// @brief Quick sort phase of introsort. Partitions not larger than
+    ///        leafThreshold are passed to leafSort(first, last). Recurses into the
+    ///        smaller part only, so the stack depth stays O(log n).
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare, typename LeafSort>
+    void introSortLoop(T* first,
+                       T* last,
+                       std::size_t depthLimit,
+                       Compare comp,
+                       LeafSort leafSort,
+                       const std::size_t leafThreshold = INSERTION_SORT_THRESHOLD)
+    {
+        while (static_cast<std::size_t>(last - first) > leafThreshold)
+        {
+            if (depthLimit == 0)
+            {
+                // Too many bad pivots, switches to O(n log n) heap sort
+                heapSort(first, last, comp);
+                return;
+            }
+            --depthLimit;
+
+            const std::pair<T*, T*> cut = partitionRange<SCHEME>(first, last, comp);
+            if (cut.first - first < last - cut.second)
+            {
+                introSortLoop<SCHEME>(first, cut.first, depthLimit, comp, leafSort, leafThreshold);
+                first = cut.second;
+            }
+            else
+            {
+                introSortLoop<SCHEME>(cut.second, last, depthLimit, comp, leafSort, leafThreshold);
+                last = cut.first;
+            }
+        }
+        leafSort(first, last);
+    }
+
+    ///=============================================================================
+    /// @brief Introsort over [first, last) with a custom kernel for the small
+    ///        partitions (e.g. sorting networks).
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    /// @param LeafSort leafSort - sorts partitions of up to leafThreshold elements.
+    /// @param const std::size_t leafThreshold - largest partition for leafSort.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare, typename LeafSort>
+    void introSort(T* first,
+                   T* last,
+                   Compare comp,
+                   LeafSort leafSort,
+                   const std::size_t leafThreshold)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size < 2)
+        {
+            return;
+        }
+
+        introSortLoop<SCHEME>(first, last, introSortDepthLimit(size), comp, leafSort, leafThreshold);
+    }
+
+    ///=============================================================================
+    /// @brief Introsort over [first, last), small partitions are finished by
+    ///        insertion sort.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare>
+    void introSort(T* first,
+                   T* last,
+                   Compare comp)
+    {
+        introSort<SCHEME>(first, last, comp,
+                  [comp](T* leafFirst, T* leafLast) { insertionSort(leafFirst, leafLast, comp); },
+                  INSERTION_SORT_THRESHOLD);
+    }
+}
+
+#endif // INTROSORT_H
@@ -0,0 +1,132 @@
+#ifndef PARALLELINTROSORT_H
+#define PARALLELINTROSORT_H
+
+#include <atomic>
+#include <cstddef>
+
+#include "IntroSort.h"
+#include "..\Parallel\WorkStealingPool.h"
+
+///=============================================================================
+/// Parallel flavour of introsort. Every partition step hands one of the two
+/// subranges to a WorkStealingPool as a new task and keeps working on the
+/// other one; idle threads steal the handed out subranges. Subranges not larger
+/// than the sequential cutoff are finished by the serial introsort.
+///
+/// The result is exactly the serial one: sorting integral keys has a single
+/// correct output, whatever the order of the tasks is.
+///=============================================================================
+namespace SortingKernels
+{
+    // Subranges which are not larger than that are sorted sequentially
+    constexpr std::size_t PARALLEL_SORT_CUTOFF = 1 << 14;
+
+    ///=============================================================================
+    /// @brief Task of the parallel introsort. Partitions [first, last) until the
+    ///        range gets below the cutoff, spawning a task per partition step.
+    ///
+    /// @param std::atomic<std::size_t>& pending - number of unfinished tasks.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME, typename T, typename Compare, typename LeafSort>
+    void parallelIntroSortTask(T* first,
+                               T* last,
+                               std::size_t depthLimit,
+                               Compare comp,
+                               LeafSort leafSort,
+                               const std::size_t leafThreshold,
+                               WorkStealingPool& pool,
+                               const std::size_t cutoff,
+                               std::atomic<std::size_t>& pending)
+    {
+        while (static_cast<std::size_t>(last - first) > cutoff && depthLimit > 0)
+        {
+            --depthLimit;
+            const std::pair<T*, T*> cut = partitionRange<SCHEME>(first, last, comp);
+
+            // Larger part goes to the pool: thieves take the oldest, i.e. the largest tasks
+            T* spawnFirst = first;
+            T* spawnLast = cut.first;
+            if (cut.first - first < last - cut.second)
+            {
+                spawnFirst = cut.second;
+                spawnLast = last;
+                last = cut.first;
+            }
+            else
+            {
+                first = cut.second;
+            }
+
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.submit([=, &pool, &pending]
+            {
+                parallelIntroSortTask<SCHEME>(spawnFirst, spawnLast, depthLimit, comp,
+                                      leafSort, leafThreshold, pool, cutoff, pending);
+            });
+        }
+
+        introSortLoop<SCHEME>(first, last, depthLimit, comp, leafSort, leafThreshold);
+
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    ///=============================================================================
+    /// @brief Parallel introsort over [first, last) on the given pool. The calling
+    ///        thread takes part in the work and returns once the range is sorted.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    /// @param LeafSort leafSort - sorts partitions of up to leafThreshold elements.
+    /// @param const std::size_t leafThreshold - largest partition for leafSort.
+    /// @param WorkStealingPool& pool - pool which executes the tasks.
+    /// @param const std::size_t cutoff - subranges of that size are sorted serially.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare, typename LeafSort>
+    void parallelIntroSort(T* first,
+                           T* last,
+                           Compare comp,
+                           LeafSort leafSort,
+                           const std::size_t leafThreshold,
+                           WorkStealingPool& pool,
+                           const std::size_t cutoff = PARALLEL_SORT_CUTOFF)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size <= cutoff || pool.workerCount() == 0)
+        {
+            introSort<SCHEME>(first, last, comp, leafSort, leafThreshold);
+            return;
+        }
+
+        std::atomic<std::size_t> pending{ 1 };
+        parallelIntroSortTask<SCHEME>(first, last, introSortDepthLimit(size), comp,
+                              leafSort, leafThreshold, pool, cutoff, pending);
+        pool.helpWhile([&pending] { return pending.load(std::memory_order_acquire) != 0; });
+    }
+
+    ///=============================================================================
+    /// @brief Parallel introsort over [first, last), small partitions are finished
+    ///        by insertion sort.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare>
+    void parallelIntroSort(T* first,
+                           T* last,
+                           Compare comp,
+                           WorkStealingPool& pool,
+                           const std::size_t cutoff = PARALLEL_SORT_CUTOFF)
+    {
+        parallelIntroSort<SCHEME>(first, last, comp,
+                          [comp](T* leafFirst, T* leafLast) { insertionSort(leafFirst, leafLast, comp); },
+                          INSERTION_SORT_THRESHOLD, pool, cutoff);
+    }
+}
+
+#endif // PARALLELINTROSORT_H
@@ -0,0 +1,303 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "..\SortStatistics.h"
+
+///=============================================================================
+/// Partition schemes of QuickSort:
+/// HOARE     - classic Hoare partition, branches on every comparison.
+/// BLOCK     - BlockQuicksort (Edelkamp, Weiss): comparison results are stored
+///             as offsets into small blocks without branching, then the
+///             misplaced elements are swapped in bulk. No branch mispredictions
+///             in the hot loop, which pays off on random keys.
+/// THREE_WAY - "fat pivot" partition into <, == and > parts. Keys equal to the
+///             pivot are excluded from the further recursion, so inputs with
+///             many duplicates do not degrade.
+///=============================================================================
+enum class PartitionScheme
+{
+    HOARE,
+    BLOCK,
+    THREE_WAY
+};
+
+///=============================================================================
+/// All kernels work over a contiguous range [first, last) and take a predicate
+/// comp(lhs, rhs) which returns true if lhs must be placed before rhs.
+///=============================================================================
+namespace SortingKernels
+{
+    // Partitions larger than that use the median of three medians as a pivot
+    constexpr std::size_t NINTHER_THRESHOLD = 128;
+
+    // Number of elements per block of the block partition
+    constexpr std::size_t PARTITION_BLOCK_SIZE = 64;
+
+    ///=============================================================================
+    /// @brief Orders three elements, so that *a <= *b <= *c.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void sort3(T* a,
+               T* b,
+               T* c,
+               Compare comp)
+    {
+        if (comp(*b, *a)) { swapElements(*a, *b); }
+        if (comp(*c, *b))
+        {
+            swapElements(*b, *c);
+            if (comp(*b, *a)) { swapElements(*a, *b); }
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Moves the pivot (median of three or ninther) to the first position.
+    ///
+    /// @param T* first - beginning of the range (at least 3 elements).
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void selectPivot(T* first,
+                     T* last,
+                     Compare comp)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        T* middle = first + size / 2;
+        if (size > NINTHER_THRESHOLD)
+        {
+            // Tukey's ninther: median of the medians of three triples
+            sort3(first + 1, middle - 1, last - 1, comp);
+            sort3(first + 2, middle, last - 2, comp);
+            sort3(first + 3, middle + 1, last - 3, comp);
+            sort3(middle - 1, middle, middle + 1, comp);
+        }
+        else
+        {
+            sort3(first + 1, middle, last - 1, comp);
+        }
+        swapElements(*first, *middle);
+    }
+
+    ///=============================================================================
+    /// @brief Hoare partition around the pivot stored in *first. Unguarded: the
+    ///        pivot selection guarantees that both scans stop inside the range.
+    ///
+    /// @param T* first - beginning of the range, holds the pivot.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return T* - cut: [first, cut) is not after the pivot, [cut, last) is not
+    ///              before the pivot.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    T* partition(T* first,
+                 T* last,
+                 Compare comp)
+    {
+        selectPivot(first, last, comp);
+
+        const T pivot{ *first };
+        T* leftIter = first + 1;
+        T* rightIter = last;
+        while (true)
+        {
+            while (comp(*leftIter, pivot))
+            {
+                ++leftIter;
+            }
+            --rightIter;
+            while (comp(pivot, *rightIter))
+            {
+                --rightIter;
+            }
+            if (!(leftIter < rightIter))
+            {
+                return leftIter;
+            }
+            swapElements(*leftIter, *rightIter);
+            ++leftIter;
+        }
+    }
+
+
+    ///=============================================================================
+    /// @brief Block partition around the pivot stored in *first (BlockQuicksort).
+    ///        Misplaced elements of a left and a right block are found without
+    ///        branches and then swapped pairwise. The remainder, shorter than
+    ///        three blocks, is finished by a guarded Hoare loop.
+    ///
+    /// @param T* first - beginning of the range, holds the pivot.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return T* - cut: [first, cut) is not after the pivot, [cut, last) is not
+    ///              before the pivot.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    T* blockPartition(T* first,
+                      T* last,
+                      Compare comp)
+    {
+        selectPivot(first, last, comp);
+
+        const T pivot{ *first };
+        T* begin = first + 1;
+        T* end = last;
+
+        unsigned char offsetsLeft[PARTITION_BLOCK_SIZE];
+        unsigned char offsetsRight[PARTITION_BLOCK_SIZE];
+        std::size_t countLeft = 0;
+        std::size_t countRight = 0;
+        std::size_t startLeft = 0;
+        std::size_t startRight = 0;
+
+        while (static_cast<std::size_t>(end - begin) > 2 * PARTITION_BLOCK_SIZE)
+        {
+            if (countLeft == 0)
+            {
+                // Elements which are not before the pivot must leave the left block
+                startLeft = 0;
+                for (std::size_t i = 0; i < PARTITION_BLOCK_SIZE; ++i)
+                {
+                    offsetsLeft[countLeft] = static_cast<unsigned char>(i);
+                    countLeft += !comp(begin[i], pivot);
+                }
+            }
+            if (countRight == 0)
+            {
+                // Elements which are not after the pivot must leave the right block
+                startRight = 0;
+                for (std::size_t i = 0; i < PARTITION_BLOCK_SIZE; ++i)
+                {
+                    offsetsRight[countRight] = static_cast<unsigned char>(i);
+                    countRight += !comp(pivot, *(end - 1 - i));
+                }
+            }
+
+            const std::size_t count = std::min(countLeft, countRight);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                swapElements(begin[offsetsLeft[startLeft + i]],
+                          *(end - 1 - offsetsRight[startRight + i]));
+            }
+            countLeft -= count;
+            countRight -= count;
+            startLeft += count;
+            startRight += count;
+
+            if (countLeft == 0)
+            {
+                begin += PARTITION_BLOCK_SIZE;
+            }
+            if (countRight == 0)
+            {
+                end -= PARTITION_BLOCK_SIZE;
+            }
+        }
+
+        // [first, begin) is not after and [end, last) is not before the pivot,
+        // a half-processed block is simply partitioned again
+        while (true)
+        {
+            while (begin < end && comp(*begin, pivot))
+            {
+                ++begin;
+            }
+            while (begin < end && comp(pivot, *(end - 1)))
+            {
+                --end;
+            }
+            if (end - begin < 2)
+            {
+                return begin;
+            }
+            swapElements(*begin, *(end - 1));
+            ++begin;
+            --end;
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Three-way ("fat pivot") partition around the pivot stored in *first.
+    ///
+    /// @param T* first - beginning of the range, holds the pivot.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return std::pair<T*, T*> - [first, .first) is before the pivot,
+    ///                             [.first, .second) is equivalent to the pivot,
+    ///                             [.second, last) is after the pivot.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    std::pair<T*, T*> threeWayPartition(T* first,
+                                        T* last,
+                                        Compare comp)
+    {
+        selectPivot(first, last, comp);
+
+        const T pivot{ *first };
+        T* less = first;
+        T* current = first + 1;
+        T* greater = last;
+        while (current < greater)
+        {
+            if (comp(*current, pivot))
+            {
+                swapElements(*less++, *current++);
+            }
+            else if (comp(pivot, *current))
+            {
+                swapElements(*current, *--greater);
+            }
+            else
+            {
+                ++current;
+            }
+        }
+        return std::make_pair(less, greater);
+    }
+
+    ///=============================================================================
+    /// @brief Partitions the range with the given scheme.
+    ///
+    /// @param T* first - beginning of the range (at least 3 elements).
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return std::pair<T*, T*> - [first, .first) and [.second, last) still have
+    ///                             to be sorted, [.first, .second) is in place.
+    ///=============================================================================
+    template <PartitionScheme SCHEME, typename T, typename Compare>
+    std::pair<T*, T*> partitionRange(T* first,
+                                     T* last,
+                                     Compare comp)
+    {
+        switch (SCHEME)
+        {
+        default:
+        case PartitionScheme::HOARE:
+        {
+            T* cut = partition(first, last, comp);
+            return std::make_pair(cut, cut);
+        }
+        case PartitionScheme::BLOCK:
+        {
+            T* cut = blockPartition(first, last, comp);
+            return std::make_pair(cut, cut);
+        }
+        case PartitionScheme::THREE_WAY:
+            return threeWayPartition(first, last, comp);
+        }
+    }
+}
+
+#endif // PARTITION_H
@@ -2,9 +2,20 @@
 #define QUICKSORT_H
 
 #include "..\SortingCore.h"
+#include "..\ConstexprSort\ConstexprSort.h"
+#include "IntroSort.h"
+#include "ParallelIntroSort.h"
+#include "..\SortingNetwork\SortingNetwork.h"
+#include "..\Selection\Selection.h"
+
+#include <stdexcept>
 
 ///=============================================================================
-/// Simple implementation of "Quick Sort".
+/// Implementation of "Quick Sort" in its introspective flavour (see IntroSort.h):
+/// median-of-three/ninther pivot, insertion sort for small partitions and
+/// heap sort fallback when the recursion gets too deep. On CPUs with AVX2 or
+/// SSE4.1, partitions of up to 64 8-, 16- or 32-bit keys are finished by SIMD
+/// sorting networks (see SortingNetwork.h) instead of insertion sort.
 /// 
 /// Example of usage:
 /// constexpr size_t arrSize = 20;
@@ -14,64 +25,399 @@
 /// qSort.print();
 /// qSort.sort(SortOrder::ASC);
 /// qSort.print();
+///
+/// Runtime-sized buffers are sorted in place, without a copy:
+/// std::vector<int> keys(...);
+/// QuickSort<int> qSort(keys.begin(), keys.end());
+/// qSort.sort();
+///
+/// The order or a custom predicate can be fixed at compile time, so the inner
+/// loops get specialized (see SortingCore.h):
+/// qSort.sort<SortOrder::DESC>();
+/// qSort.sortBy([](const int lhs, const int rhs) { return lhs % 10 < rhs % 10; });
+///
+/// Large buffers can be sorted by all cores (see ParallelIntroSort.h):
+/// qSort.parallelSort(SortOrder::ASC);                  // hardware_concurrency() threads
+/// qSort.parallelSort(SortOrder::ASC, 8, 1 << 16);      // 8 threads, 64K sequential cutoff
+///
+/// When only a few keys are needed, selection skips the full sort (see
+/// Selection.h):
+/// const int median = qSort.nthElement(qSort.size() / 2);
+/// qSort.partialSort(10, SortOrder::DESC);              // 10 largest keys first, in order
+///
+/// Partition scheme is selectable (see Partition.h):
+/// qSort.setPartitionScheme(PartitionScheme::THREE_WAY); // many duplicate keys
+/// qSort.sort();
+///
+/// Tables known at compile time are sorted by the compiler:
+/// constexpr auto table = QuickSort<int>::sorted(std::array<int, 4>{ 3, 1, 4, 2 });
 ///=============================================================================
-template <typename T, size_t SIZE>
+template <typename T, size_t SIZE = DYNAMIC_SIZE>
 class QuickSort : public SortingCore<T, SIZE>
 {
 public:
-    ///=============================================================================
-    ///=============================================================================
-    QuickSort(T* inputArray)
-        : SortingCore<T, SIZE>(inputArray)
-    {}
+    using SortingCore<T, SIZE>::SortingCore;
 
     ///=============================================================================
     ///=============================================================================
     ~QuickSort() {}
 
     ///=============================================================================
+    /// @brief Sorts the array with introsort: worst-case O(n log n) comparisons
+    ///        and O(log n) stack depth, whatever the input is. Dispatches once on
+    ///        the runtime order to sort<ORDER>().
+    ///
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
     ///=============================================================================
     void sort(const SortOrder order = SortOrder::ASC)
     {
-        this->sort(0, SIZE, order);
+        if (order == SortOrder::ASC)
+        {
+            sort<SortOrder::ASC>();
+        }
+        else
+        {
+            sort<SortOrder::DESC>();
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array in the order known at compile time.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    void sort()
+    {
+        if (SortingKernels::hasVectorNetwork<T>())
+        {
+            introSort(OrderedBefore<T, ORDER>(), networkLeafSort<ORDER>(),
+                      SortingKernels::NETWORK_MAX_SIZE);
+        }
+        else
+        {
+            introSort(OrderedBefore<T, ORDER>(), insertionLeafSort(OrderedBefore<T, ORDER>()),
+                      SortingKernels::INSERTION_SORT_THRESHOLD);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array by a user-supplied predicate over projected keys.
+    ///
+    /// @param Compare comp - returns true if the first key must be placed before
+    ///                       the second one (like std::less).
+    /// @param Projection proj - maps an element onto the key to compare.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Compare, typename Projection = IdentityProjection>
+    void sortBy(Compare comp,
+                Projection proj = Projection())
+    {
+        const auto before = makeProjectedBefore(comp, proj);
+        introSort(before, insertionLeafSort(before), SortingKernels::INSERTION_SORT_THRESHOLD);
+    }
+
+    ///=============================================================================
+    /// @brief Introselect: puts into position k the element which would be there
+    ///        after sort(order); elements before it are not placed after it, and
+    ///        elements after it are not placed before it. O(n) on average.
+    ///
+    /// @param const std::size_t k - position to select.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return T - the selected element.
+    ///=============================================================================
+    T nthElement(const std::size_t k,
+                 const SortOrder order = SortOrder::ASC)
+    {
+        return order == SortOrder::ASC ? nthElement<SortOrder::ASC>(k)
+                                       : nthElement<SortOrder::DESC>(k);
+    }
+
+    ///=============================================================================
+    /// @brief Introselect in the order known at compile time.
+    ///
+    /// @param const std::size_t k - position to select.
+    ///
+    /// @return T - the selected element.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    T nthElement(const std::size_t k)
+    {
+        if (k >= this->size())
+        {
+            throw std::out_of_range("QuickSort::nthElement: position is out of range");
+        }
+        introSelect(this->data() + k, OrderedBefore<T, ORDER>());
+        return this->data()[k];
+    }
+
+    ///=============================================================================
+    /// @brief Partial sort: the k first elements of sort(order) are put in place,
+    ///        the rest of the array is left unordered. O(n + k log k).
+    ///
+    /// @param const std::size_t k - number of elements to sort.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void partialSort(const std::size_t k,
+                     const SortOrder order = SortOrder::ASC)
+    {
+        if (order == SortOrder::ASC)
+        {
+            partialSort<SortOrder::ASC>(k);
+        }
+        else
+        {
+            partialSort<SortOrder::DESC>(k);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Partial sort in the order known at compile time.
+    ///
+    /// @param const std::size_t k - number of elements to sort (clamped to size).
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    void partialSort(const std::size_t k)
+    {
+        partialSort(this->data() + (k < this->size() ? k : this->size()), OrderedBefore<T, ORDER>());
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array with parallel introsort. The output is the same as
+    ///        the one of sort().
+    ///
+    /// @param const SortOrder order - sort order.
+    /// @param const std::size_t threadCount - number of threads, including the
+    ///                                        calling one (0 - all hardware threads).
+    /// @param const std::size_t cutoff - subranges of that size are sorted serially.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void parallelSort(const SortOrder order = SortOrder::ASC,
+                      const std::size_t threadCount = 0,
+                      const std::size_t cutoff = SortingKernels::PARALLEL_SORT_CUTOFF)
+    {
+        WorkStealingPool pool(threadCount == 0 ? WorkStealingPool::defaultWorkerCount()
+                                               : threadCount - 1);
+        parallelSort(pool, order, cutoff);
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array with parallel introsort on an existing pool, which
+    ///        saves thread start-up when many arrays are sorted.
+    ///
+    /// @param WorkStealingPool& pool - pool which executes the tasks.
+    /// @param const SortOrder order - sort order.
+    /// @param const std::size_t cutoff - subranges of that size are sorted serially.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void parallelSort(WorkStealingPool& pool,
+                      const SortOrder order = SortOrder::ASC,
+                      const std::size_t cutoff = SortingKernels::PARALLEL_SORT_CUTOFF)
+    {
+        if (order == SortOrder::ASC)
+        {
+            parallelSort<SortOrder::ASC>(pool, cutoff);
+        }
+        else
+        {
+            parallelSort<SortOrder::DESC>(pool, cutoff);
+        }
     }
 
+    ///=============================================================================
+    /// @brief Parallel introsort in the order known at compile time.
+    ///
+    /// @param WorkStealingPool& pool - pool which executes the tasks.
+    /// @param const std::size_t cutoff - subranges of that size are sorted serially.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    void parallelSort(WorkStealingPool& pool,
+                      const std::size_t cutoff = SortingKernels::PARALLEL_SORT_CUTOFF)
+    {
+        if (SortingKernels::hasVectorNetwork<T>())
+        {
+            parallelIntroSort(pool, cutoff, OrderedBefore<T, ORDER>(), networkLeafSort<ORDER>(),
+                              SortingKernels::NETWORK_MAX_SIZE);
+        }
+        else
+        {
+            parallelIntroSort(pool, cutoff, OrderedBefore<T, ORDER>(),
+                              insertionLeafSort(OrderedBefore<T, ORDER>()),
+                              SortingKernels::INSERTION_SORT_THRESHOLD);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts a std::array, at compile time when used in a constant
+    ///        expression (see ConstexprSort.h).
+    ///
+    /// @param std::array<T, N> array - array to sort.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return std::array<T, N> - sorted array.
+    ///=============================================================================
+    template <std::size_t N>
+    static constexpr std::array<T, N> sorted(const std::array<T, N>& array,
+                                             const SortOrder order = SortOrder::ASC)
+    {
+        return order == SortOrder::ASC
+            ? SortingKernels::constexprSort(array, OrderedBefore<T, SortOrder::ASC>())
+            : SortingKernels::constexprSort(array, OrderedBefore<T, SortOrder::DESC>());
+    }
+
+    ///=============================================================================
+    /// @brief Selects the partition scheme used by sort() and parallelSort().
+    ///
+    /// @param const PartitionScheme scheme - partition scheme.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void setPartitionScheme(const PartitionScheme scheme) noexcept { m_partitionScheme = scheme; }
+
+    ///=============================================================================
+    ///=============================================================================
+    PartitionScheme partitionScheme() const noexcept { return m_partitionScheme; }
+
 private:
+    PartitionScheme m_partitionScheme = PartitionScheme::HOARE;
+
+    ///=============================================================================
+    /// @brief Runs the serial introsort with the selected partition scheme.
+    ///=============================================================================
+    template <typename Compare, typename LeafSort>
+    void introSort(Compare comp,
+                   LeafSort leafSort,
+                   const std::size_t leafThreshold)
+    {
+        T* first = this->data();
+        T* last = first + this->size();
+        switch (m_partitionScheme)
+        {
+        default:
+        case PartitionScheme::HOARE:
+            SortingKernels::introSort<PartitionScheme::HOARE>(first, last, comp, leafSort, leafThreshold);
+            break;
+        case PartitionScheme::BLOCK:
+            SortingKernels::introSort<PartitionScheme::BLOCK>(first, last, comp, leafSort, leafThreshold);
+            break;
+        case PartitionScheme::THREE_WAY:
+            SortingKernels::introSort<PartitionScheme::THREE_WAY>(first, last, comp, leafSort, leafThreshold);
+            break;
+        }
+    }
+
     ///=============================================================================
+    /// @brief Runs the introselect with the selected partition scheme.
     ///=============================================================================
-    void sort(T leftIter,
-              T rightIter,
-              const SortOrder order)
+    template <typename Compare>
+    void introSelect(T* nth,
+                     Compare comp)
     {
-        if (leftIter < rightIter)
+        T* first = this->data();
+        T* last = first + this->size();
+        switch (m_partitionScheme)
         {
-            T pivot = partition(leftIter, rightIter, order);
-            sort(leftIter, pivot, order);
-            sort(leftIter + 1, rightIter, order); // leftIter + 1
+        default:
+        case PartitionScheme::HOARE:
+            SortingKernels::introSelect<PartitionScheme::HOARE>(first, nth, last, comp);
+            break;
+        case PartitionScheme::BLOCK:
+            SortingKernels::introSelect<PartitionScheme::BLOCK>(first, nth, last, comp);
+            break;
+        case PartitionScheme::THREE_WAY:
+            SortingKernels::introSelect<PartitionScheme::THREE_WAY>(first, nth, last, comp);
+            break;
         }
     }
 
     ///=============================================================================
+    /// @brief Runs the partial sort with the selected partition scheme.
     ///=============================================================================
-    T partition(T leftBound,
-                T rightBound,
-                const SortOrder order)
+    template <typename Compare>
+    void partialSort(T* middle,
+                     Compare comp)
     {
-        T pivot = leftBound;
-        T leftIter = leftBound;
-        for (int rightIter = leftBound + 1; rightIter < rightBound; ++rightIter)
+        T* first = this->data();
+        T* last = first + this->size();
+        switch (m_partitionScheme)
         {
-            if (this->compare(this->m_array[rightIter],
-                              this->m_array[pivot], order))
-            {
-                leftIter += 1;
-                this->swap(this->m_array[leftIter],
-                           this->m_array[rightIter]);
-            }
+        default:
+        case PartitionScheme::HOARE:
+            SortingKernels::partialSort<PartitionScheme::HOARE>(first, middle, last, comp);
+            break;
+        case PartitionScheme::BLOCK:
+            SortingKernels::partialSort<PartitionScheme::BLOCK>(first, middle, last, comp);
+            break;
+        case PartitionScheme::THREE_WAY:
+            SortingKernels::partialSort<PartitionScheme::THREE_WAY>(first, middle, last, comp);
+            break;
         }
-        this->swap(this->m_array[leftIter],
-                   this->m_array[leftBound]);
-        return leftIter;
+    }
+
+    ///=============================================================================
+    /// @brief Runs the parallel introsort with the selected partition scheme.
+    ///=============================================================================
+    template <typename Compare, typename LeafSort>
+    void parallelIntroSort(WorkStealingPool& pool,
+                           const std::size_t cutoff,
+                           Compare comp,
+                           LeafSort leafSort,
+                           const std::size_t leafThreshold)
+    {
+        T* first = this->data();
+        T* last = first + this->size();
+        switch (m_partitionScheme)
+        {
+        default:
+        case PartitionScheme::HOARE:
+            SortingKernels::parallelIntroSort<PartitionScheme::HOARE>(
+                first, last, comp, leafSort, leafThreshold, pool, cutoff);
+            break;
+        case PartitionScheme::BLOCK:
+            SortingKernels::parallelIntroSort<PartitionScheme::BLOCK>(
+                first, last, comp, leafSort, leafThreshold, pool, cutoff);
+            break;
+        case PartitionScheme::THREE_WAY:
+            SortingKernels::parallelIntroSort<PartitionScheme::THREE_WAY>(
+                first, last, comp, leafSort, leafThreshold, pool, cutoff);
+            break;
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Base case of the introsort: insertion sort by the given predicate.
+    ///=============================================================================
+    template <typename Compare>
+    static auto insertionLeafSort(Compare comp)
+    {
+        return [comp](T* first, T* last)
+        {
+            SortingKernels::insertionSort(first, last, comp);
+        };
+    }
+
+    ///=============================================================================
+    /// @brief Base case of the introsort: sorting network for the given order.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    static auto networkLeafSort()
+    {
+        return [](T* first, T* last)
+        {
+            SortingKernels::networkSort(first, last, ORDER);
+        };
     }
 };
 
@@ -0,0 +1,146 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <climits>
+#include <cstring>
+#include <memory>
+
+#include "..\SortingCore.h"
+
+///=============================================================================
+/// Kernel of LSD (least significant digit first) radix sort by bytes.
+///
+/// Keys are mapped onto unsigned integers which compare in the requested order:
+/// the sign bit is flipped for signed types and all the bits are flipped for
+/// SortOrder::DESC. Histograms of every byte are gathered in a single read pass
+/// before scattering, and a pass is skipped when all the keys share the same
+/// byte value, so e.g. 64-bit IDs below 2^32 cost four passes instead of eight.
+///=============================================================================
+namespace SortingKernels
+{
+    ///=============================================================================
+    /// @brief Stable LSD radix sort of [first, last).
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param T* buffer - scratch buffer of (last - first) elements.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T>
+    void radixSort(T* first,
+                   T* last,
+                   T* buffer,
+                   const SortOrder order = SortOrder::ASC)
+    {
+        static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                      "Integral non-bool value is required.");
+
+        using Key = typename std::make_unsigned<T>::type;
+        constexpr std::size_t BYTES = sizeof(T);
+        constexpr std::size_t BUCKETS = 1 << CHAR_BIT;
+
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size < 2)
+        {
+            return;
+        }
+
+        // Maps keys onto unsigned values of the requested order
+        const Key signBit = std::is_signed<T>::value
+            ? static_cast<Key>(Key(1) << (BYTES * CHAR_BIT - 1))
+            : Key(0);
+        const Key mask = order == SortOrder::ASC ? signBit : static_cast<Key>(~signBit);
+
+        // One read pass fills the histograms of all the bytes
+        std::size_t histograms[BYTES][BUCKETS] = {};
+        for (const T* current = first; current != last; ++current)
+        {
+            const Key key = static_cast<Key>(static_cast<Key>(*current) ^ mask);
+            for (std::size_t byte = 0; byte < BYTES; ++byte)
+            {
+                ++histograms[byte][(key >> (byte * CHAR_BIT)) & (BUCKETS - 1)];
+            }
+        }
+
+        T* source = first;
+        T* destination = buffer;
+        for (std::size_t byte = 0; byte < BYTES; ++byte)
+        {
+            std::size_t* histogram = histograms[byte];
+
+            // Every key has the same byte value: the pass would not move anything
+            const Key firstKey = static_cast<Key>(static_cast<Key>(*source) ^ mask);
+            if (histogram[(firstKey >> (byte * CHAR_BIT)) & (BUCKETS - 1)] == size)
+            {
+                continue;
+            }
+
+            // Counts -> starting offsets
+            std::size_t offset = 0;
+            for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                const std::size_t count = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += count;
+            }
+
+            for (const T* current = source; current != source + size; ++current)
+            {
+                const Key key = static_cast<Key>(static_cast<Key>(*current) ^ mask);
+                destination[histogram[(key >> (byte * CHAR_BIT)) & (BUCKETS - 1)]++] = *current;
+            }
+            std::swap(source, destination);
+        }
+
+        // Odd number of passes leaves the result in the scratch buffer
+        if (source != first)
+        {
+            std::memcpy(first, source, size * sizeof(T));
+        }
+    }
+}
+
+///=============================================================================
+/// Implementation of LSD "Radix Sort" by bytes. O(n * sizeof(T)) time, needs a
+/// scratch buffer of the array size, which is allocated per sort() call.
+///
+/// Example of usage:
+/// constexpr size_t arrSize = 20;
+/// int inputArray[arrSize]{ 9, -85, 7, 6, 53, -4, 3, 21, 1, ... };
+/// RadixSort<int, arrSize> radixSort(inputArray);
+/// radixSort.sort(SortOrder::DESC);
+/// radixSort.print();
+///
+/// Runtime-sized buffers are sorted in place, without a copy:
+/// std::vector<std::uint64_t> ids(...);
+/// RadixSort<std::uint64_t> radixSort(ids);
+/// radixSort.sort();
+///=============================================================================
+template <typename T, size_t SIZE = DYNAMIC_SIZE>
+class RadixSort : public SortingCore<T, SIZE>
+{
+public:
+    using SortingCore<T, SIZE>::SortingCore;
+
+    ///=============================================================================
+    ///=============================================================================
+    ~RadixSort() {}
+
+    ///=============================================================================
+    /// @brief Sorts the array. The sort is stable.
+    ///
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void sort(const SortOrder order = SortOrder::ASC)
+    {
+        std::unique_ptr<T[]> buffer(new T[this->size()]);
+        SortingKernels::radixSort(this->data(), this->data() + this->size(),
+                                  buffer.get(), order);
+    }
+};
+
+#endif // RADIXSORT_H
@@ -0,0 +1,282 @@
+#ifndef SEGMENTEDSORT_H
+#define SEGMENTEDSORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "..\SortingCore.h"
+#include "..\QuickSort\IntroSort.h"
+#include "..\RadixSort\RadixSort.h"
+#include "..\SortingNetwork\SortingNetwork.h"
+#include "..\Parallel\WorkStealingPool.h"
+
+///=============================================================================
+/// Segmented sort: many independent arrays stored back to back in one flat
+/// buffer are sorted by a single call. Segment i is
+/// [data + offsets[i], data + offsets[i + 1]), so segmentCount segments take
+/// segmentCount + 1 offsets (CSR layout).
+///
+/// Each segment gets the kernel which suits its length:
+/// - up to INSERTION_SORT_THRESHOLD elements: insertion sort;
+/// - up to NETWORK_MAX_SIZE elements, if SIMD networks are available for T:
+///   a sorting network;
+/// - from SEGMENT_RADIX_THRESHOLD elements: LSD radix sort;
+/// - introsort otherwise.
+/// Nothing is allocated per segment: the radix scratch is shared by all
+/// segments of a thread.
+///=============================================================================
+namespace SortingKernels
+{
+    // Segments which are not shorter than that are sorted by radix sort
+    constexpr std::size_t SEGMENT_RADIX_THRESHOLD = 1024;
+
+    // Segments are handed to the pool in batches of about that many elements
+    constexpr std::size_t SEGMENT_TASK_ELEMENTS = 1 << 15;
+
+    ///=============================================================================
+    /// @brief Sorts the segments [firstSegment, lastSegment) one by one.
+    ///
+    /// @param T* data - flat buffer of all the segments.
+    /// @param const std::size_t* offsets - segment boundaries.
+    /// @param const std::size_t firstSegment - first segment to sort.
+    /// @param const std::size_t lastSegment - end of the segments to sort.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER, typename T>
+    void sortSegments(T* data,
+                      const std::size_t* offsets,
+                      const std::size_t firstSegment,
+                      const std::size_t lastSegment)
+    {
+        const OrderedBefore<T, ORDER> comp;
+        const bool vectorNetwork = hasVectorNetwork<T>();
+        const auto leafSort = [vectorNetwork, comp](T* leafFirst, T* leafLast)
+        {
+            if (vectorNetwork)
+            {
+                networkSort(leafFirst, leafLast, ORDER);
+            }
+            else
+            {
+                insertionSort(leafFirst, leafLast, comp);
+            }
+        };
+        const std::size_t leafThreshold = vectorNetwork ? NETWORK_MAX_SIZE : INSERTION_SORT_THRESHOLD;
+
+        std::vector<T> buffer;
+        for (std::size_t segment = firstSegment; segment < lastSegment; ++segment)
+        {
+            T* first = data + offsets[segment];
+            T* last = data + offsets[segment + 1];
+            const std::size_t size = static_cast<std::size_t>(last - first);
+            if (size <= INSERTION_SORT_THRESHOLD)
+            {
+                insertionSort(first, last, comp);
+            }
+            else if (size <= leafThreshold)
+            {
+                leafSort(first, last);
+            }
+            else if (size >= SEGMENT_RADIX_THRESHOLD)
+            {
+                if (buffer.size() < size)
+                {
+                    buffer.resize(size);
+                }
+                radixSort(first, last, buffer.data(), ORDER);
+            }
+            else
+            {
+                introSort(first, last, comp, leafSort, leafThreshold);
+            }
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts all the segments on the calling thread.
+    ///
+    /// @param T* data - flat buffer of all the segments.
+    /// @param const std::size_t* offsets - segmentCount + 1 segment boundaries.
+    /// @param const std::size_t segmentCount - number of segments.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T>
+    void segmentedSort(T* data,
+                       const std::size_t* offsets,
+                       const std::size_t segmentCount,
+                       const SortOrder order = SortOrder::ASC)
+    {
+        if (order == SortOrder::ASC)
+        {
+            sortSegments<SortOrder::ASC>(data, offsets, 0, segmentCount);
+        }
+        else
+        {
+            sortSegments<SortOrder::DESC>(data, offsets, 0, segmentCount);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the segments on the pool. Consecutive segments are batched
+    ///        into tasks of about taskElements elements, so that short segments
+    ///        do not pay for a task each. The calling thread takes part in the
+    ///        work and returns once all the segments are sorted.
+    ///
+    /// @param T* data - flat buffer of all the segments.
+    /// @param const std::size_t* offsets - segmentCount + 1 segment boundaries.
+    /// @param const std::size_t segmentCount - number of segments.
+    /// @param WorkStealingPool& pool - pool which executes the tasks.
+    /// @param const std::size_t taskElements - elements per task.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER, typename T>
+    void parallelSegmentedSort(T* data,
+                               const std::size_t* offsets,
+                               const std::size_t segmentCount,
+                               WorkStealingPool& pool,
+                               const std::size_t taskElements = SEGMENT_TASK_ELEMENTS)
+    {
+        if (segmentCount == 0)
+        {
+            return;
+        }
+        if (pool.workerCount() == 0 || offsets[segmentCount] - offsets[0] <= taskElements)
+        {
+            sortSegments<ORDER>(data, offsets, 0, segmentCount);
+            return;
+        }
+
+        std::atomic<std::size_t> pending{ 0 };
+        std::size_t batchBegin = 0;
+        while (batchBegin < segmentCount)
+        {
+            std::size_t batchEnd = batchBegin + 1;
+            while (batchEnd < segmentCount && offsets[batchEnd] - offsets[batchBegin] < taskElements)
+            {
+                ++batchEnd;
+            }
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.submit([=, &pending]
+            {
+                sortSegments<ORDER>(data, offsets, batchBegin, batchEnd);
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            });
+            batchBegin = batchEnd;
+        }
+        pool.helpWhile([&pending] { return pending.load(std::memory_order_acquire) != 0; });
+    }
+}
+
+///=============================================================================
+/// Engine which sorts every segment of a flat buffer independently (see
+/// above). One object covers the whole batch, so there is no per-segment copy
+/// and no per-segment virtual call.
+///
+/// Example of usage:
+/// std::vector<int> values = { 5, 1, 3,   9, 8,   4, 7, 2, 6 };
+/// std::vector<std::size_t> offsets = { 0, 3, 5, 9 };
+/// SegmentedSort<int> segmentedSort(values.data(), offsets.data(), offsets.size() - 1);
+/// segmentedSort.sort();                                // 1 3 5   8 9   2 4 6 7
+/// segmentedSort.parallelSort(SortOrder::DESC);         // all cores
+///=============================================================================
+template <typename T>
+class SegmentedSort : public SortingCore<T, DYNAMIC_SIZE>
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param T* data - caller-owned flat buffer of all the segments.
+    /// @param const std::size_t* offsets - caller-owned segmentCount + 1
+    ///                                     non-decreasing segment boundaries.
+    /// @param const std::size_t segmentCount - number of segments.
+    ///=============================================================================
+    SegmentedSort(T* data,
+                  const std::size_t* offsets,
+                  const std::size_t segmentCount)
+        : SortingCore<T, DYNAMIC_SIZE>(data, segmentCount == 0 ? 0 : offsets[segmentCount])
+        , m_offsets(offsets)
+        , m_segmentCount(segmentCount)
+    {
+        for (std::size_t segment = 0; segment < segmentCount; ++segment)
+        {
+            if (offsets[segment + 1] < offsets[segment])
+            {
+                throw std::invalid_argument("SegmentedSort: offsets must not decrease");
+            }
+        }
+    }
+
+    ///=============================================================================
+    ///=============================================================================
+    ~SegmentedSort() {}
+
+    ///=============================================================================
+    /// @brief Sorts every segment on the calling thread.
+    ///
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void sort(const SortOrder order = SortOrder::ASC)
+    {
+        SortingKernels::segmentedSort(this->data(), m_offsets, m_segmentCount, order);
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the segments in parallel on a new pool.
+    ///
+    /// @param const SortOrder order - sort order.
+    /// @param const std::size_t threadCount - number of threads, including the
+    ///                                        calling one (0 - all hardware threads).
+    ///
+    /// @return void.
+    ///=============================================================================
+    void parallelSort(const SortOrder order = SortOrder::ASC,
+                      const std::size_t threadCount = 0)
+    {
+        WorkStealingPool pool(threadCount == 0 ? WorkStealingPool::defaultWorkerCount()
+                                               : threadCount - 1);
+        parallelSort(pool, order);
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the segments in parallel on the given pool.
+    ///
+    /// @param WorkStealingPool& pool - pool which executes the tasks.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void parallelSort(WorkStealingPool& pool,
+                      const SortOrder order = SortOrder::ASC)
+    {
+        if (order == SortOrder::ASC)
+        {
+            SortingKernels::parallelSegmentedSort<SortOrder::ASC>(this->data(), m_offsets,
+                                                                  m_segmentCount, pool);
+        }
+        else
+        {
+            SortingKernels::parallelSegmentedSort<SortOrder::DESC>(this->data(), m_offsets,
+                                                                   m_segmentCount, pool);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Gets the number of segments.
+    ///=============================================================================
+    std::size_t segmentCount() const noexcept { return m_segmentCount; }
+
+private:
+    const std::size_t* m_offsets;
+    std::size_t        m_segmentCount;
+};
+
+#endif // SEGMENTEDSORT_H
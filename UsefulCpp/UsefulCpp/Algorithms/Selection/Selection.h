@@ -0,0 +1,274 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "..\SortingCore.h"
+#include "..\QuickSort\IntroSort.h"
+
+///=============================================================================
+/// Selection kernels: the k-th element, the k first elements in order, or the
+/// k first elements of a stream, without sorting everything.
+///
+/// introSelect - nth_element: quickselect over the partition schemes of
+///               Partition.h with a heap select fallback, O(n) on average and
+///               O(n log k) in the worst case.
+/// partialSort - the k first elements in sorted order, O(n + k log k).
+/// TopK/topK   - the k first elements of a single pass over any input
+///               iterator, O(n log k) time and O(k) memory.
+///
+/// All of them take a predicate comp(lhs, rhs) which returns true if lhs must
+/// be placed before rhs (like std::less): "first" means smallest for the
+/// ascending order and largest for the descending one.
+///
+/// Example of usage:
+/// std::vector<int> latencies = load();
+/// SortingKernels::introSelect(latencies.data(), latencies.data() + latencies.size() / 2,
+///                             latencies.data() + latencies.size(), std::less<int>());
+/// std::vector<int> slowest = SortingKernels::topK<SortOrder::DESC>(
+///     std::istream_iterator<int>(input), std::istream_iterator<int>(), 10);
+///=============================================================================
+namespace SortingKernels
+{
+    ///=============================================================================
+    /// @brief Heap select: moves the (middle - first) first elements of the
+    ///        range to [first, middle), as a heap whose root is placed last.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* middle - end of the selected part.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void heapSelect(T* first,
+                    T* middle,
+                    T* last,
+                    Compare comp)
+    {
+        const std::size_t size = static_cast<std::size_t>(middle - first);
+        if (size == 0)
+        {
+            return;
+        }
+        for (std::size_t root = size / 2; root-- > 0; )
+        {
+            siftDown(first, root, size, comp);
+        }
+        for (T* current = middle; current < last; ++current)
+        {
+            if (comp(*current, *first))
+            {
+                swapElements(*current, *first);
+                siftDown(first, 0, size, comp);
+            }
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Introselect (nth_element): places into *nth the element which
+    ///        would be there if the range was sorted; [first, nth) is not after
+    ///        it and (nth, last) is not before it.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* nth - position to select.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare>
+    void introSelect(T* first,
+                     T* nth,
+                     T* last,
+                     Compare comp)
+    {
+        if (nth >= last)
+        {
+            return;
+        }
+
+        std::size_t depthLimit = introSortDepthLimit(static_cast<std::size_t>(last - first));
+        while (static_cast<std::size_t>(last - first) > INSERTION_SORT_THRESHOLD)
+        {
+            if (depthLimit == 0)
+            {
+                // Too many bad pivots: the root of the heap of the (nth - first + 1)
+                // first elements is the one to select
+                heapSelect(first, nth + 1, last, comp);
+                swapElements(*first, *nth);
+                return;
+            }
+            --depthLimit;
+
+            const std::pair<T*, T*> cut = partitionRange<SCHEME>(first, last, comp);
+            if (nth < cut.first)
+            {
+                last = cut.first;
+            }
+            else if (nth >= cut.second)
+            {
+                first = cut.second;
+            }
+            else
+            {
+                // Inside the run of elements equal to the pivot
+                return;
+            }
+        }
+        insertionSort(first, last, comp);
+    }
+
+    ///=============================================================================
+    /// @brief Partial sort: [first, middle) gets the (middle - first) first
+    ///        elements of the range in sorted order, the rest is left unordered.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* middle - end of the part to sort.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <PartitionScheme SCHEME = PartitionScheme::HOARE,
+              typename T, typename Compare>
+    void partialSort(T* first,
+                     T* middle,
+                     T* last,
+                     Compare comp)
+    {
+        if (middle <= first)
+        {
+            return;
+        }
+        if (middle < last)
+        {
+            introSelect<SCHEME>(first, middle - 1, last, comp);
+        }
+        introSort<SCHEME>(first, middle - (middle < last ? 1 : 0), comp);
+    }
+
+    ///=============================================================================
+    /// Streaming top-k: keeps the k first elements pushed so far in a bounded
+    /// heap whose root is the last one of them, so a new element is rejected by
+    /// a single comparison once the heap is full.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    class TopK
+    {
+    public:
+        ///=============================================================================
+        /// @brief Constructor.
+        ///
+        /// @param const std::size_t k - number of elements to keep.
+        /// @param Compare comp - "placed before" predicate.
+        ///=============================================================================
+        explicit TopK(const std::size_t k,
+                      Compare comp = Compare())
+            : m_capacity(k)
+            , m_comp(comp)
+        {
+            m_heap.reserve(k);
+        }
+
+        ///=============================================================================
+        /// @brief Offers an element.
+        ///
+        /// @param const T& value - element.
+        ///
+        /// @return void.
+        ///=============================================================================
+        void push(const T& value)
+        {
+            if (m_heap.size() < m_capacity)
+            {
+                m_heap.push_back(value);
+                std::push_heap(m_heap.begin(), m_heap.end(), m_comp);
+            }
+            else if (m_capacity > 0 && m_comp(value, m_heap.front()))
+            {
+                m_heap.front() = value;
+                siftDown(m_heap.data(), 0, m_heap.size(), m_comp);
+            }
+        }
+
+        ///=============================================================================
+        /// @brief Gets the number of elements kept.
+        ///=============================================================================
+        std::size_t size() const noexcept { return m_heap.size(); }
+
+        ///=============================================================================
+        /// @brief Takes the kept elements out in sorted order. The object is empty
+        ///        afterwards.
+        ///
+        /// @return std::vector<T> - up to k first elements, sorted.
+        ///=============================================================================
+        std::vector<T> take()
+        {
+            std::sort_heap(m_heap.begin(), m_heap.end(), m_comp);
+            std::vector<T> result;
+            result.swap(m_heap);
+            m_heap.reserve(m_capacity);
+            return result;
+        }
+
+    private:
+        std::size_t    m_capacity;
+        Compare        m_comp;
+        std::vector<T> m_heap;
+    };
+
+    ///=============================================================================
+    /// @brief Top-k of a single pass over an input range.
+    ///
+    /// @param InputIterator first - beginning of the input.
+    /// @param InputIterator last - end of the input.
+    /// @param const std::size_t k - number of elements to keep.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return std::vector<T> - up to k first elements, sorted.
+    ///=============================================================================
+    template <typename InputIterator, typename Compare>
+    auto topK(InputIterator first,
+              InputIterator last,
+              const std::size_t k,
+              Compare comp)
+        -> std::vector<typename std::iterator_traits<InputIterator>::value_type>
+    {
+        using T = typename std::iterator_traits<InputIterator>::value_type;
+        TopK<T, Compare> heap(k, comp);
+        for (; first != last; ++first)
+        {
+            heap.push(*first);
+        }
+        return heap.take();
+    }
+
+    ///=============================================================================
+    /// @brief Top-k of a single pass over an input range in the given order:
+    ///        the k smallest elements for ASC, the k largest ones for DESC.
+    ///
+    /// @param InputIterator first - beginning of the input.
+    /// @param InputIterator last - end of the input.
+    /// @param const std::size_t k - number of elements to keep.
+    ///
+    /// @return std::vector<T> - up to k first elements, sorted.
+    ///=============================================================================
+    template <SortOrder ORDER, typename InputIterator>
+    auto topK(InputIterator first,
+              InputIterator last,
+              const std::size_t k)
+        -> std::vector<typename std::iterator_traits<InputIterator>::value_type>
+    {
+        using T = typename std::iterator_traits<InputIterator>::value_type;
+        return topK(first, last, k, OrderedBefore<T, ORDER>());
+    }
+}
+
+#endif // SELECTION_H
@@ -0,0 +1,53 @@
+#ifndef SORTSTATISTICS_H
+#define SORTSTATISTICS_H
+
+#include <cstdint>
+#include <utility>
+
+///=============================================================================
+/// Operation counters of the sorting kernels. Swaps are counted only when the
+/// code is built with SORTING_COLLECT_STATISTICS defined, otherwise
+/// swapElements() is a plain std::swap and costs nothing. Counters are per
+/// thread, so they are exact for serial sorts only. Comparisons are not counted
+/// here: wrap the predicate instead (see CountingLess in SortBenchmark.h).
+///
+/// Example of usage (with -DSORTING_COLLECT_STATISTICS):
+/// SortingKernels::statistics() = SortStatistics();
+/// qSort.sort();
+/// std::cout << SortingKernels::statistics().swaps << std::endl;
+///=============================================================================
+struct SortStatistics
+{
+    std::uint64_t swaps = 0;
+};
+
+namespace SortingKernels
+{
+    ///=============================================================================
+    /// @brief Gets the counters of the calling thread.
+    ///
+    /// @return SortStatistics& - counters.
+    ///=============================================================================
+    inline SortStatistics& statistics()
+    {
+        static thread_local SortStatistics counters;
+        return counters;
+    }
+
+    ///=============================================================================
+    /// @brief Swaps two elements, counting the swap if statistics are enabled.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T>
+    inline void swapElements(T& element1,
+                             T& element2)
+    {
+#if defined(SORTING_COLLECT_STATISTICS)
+        ++statistics().swaps;
+#endif
+        std::swap(element1, element2);
+    }
+}
+
+#endif // SORTSTATISTICS_H
@@ -1,10 +1,19 @@
 #ifndef SORTCORE_H
 #define SORTCORE_H
 
+#include <charconv>
+#include <cstddef>
 #include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 #include <iostream>
 
+#include "SortStatistics.h"
+
 ///=============================================================================
 ///=============================================================================
 enum class SortOrder
@@ -14,20 +23,207 @@ enum class SortOrder
 };
 
 ///=============================================================================
+/// "Placed before" predicate of a sort order known at compile time. Unlike
+/// SortingCore::compare() there is no switch per comparison, so the inner
+/// loops of the engines get inlined into straight-line code.
+///=============================================================================
+template <typename T, SortOrder ORDER>
+struct OrderedBefore
+{
+    constexpr bool operator()(const T lhs, const T rhs) const noexcept
+    {
+        return ORDER == SortOrder::ASC ? lhs < rhs : rhs < lhs;
+    }
+};
+
+///=============================================================================
+/// Projection which leaves the element as is.
+///=============================================================================
+struct IdentityProjection
+{
+    template <typename U>
+    constexpr U&& operator()(U&& value) const noexcept
+    {
+        return std::forward<U>(value);
+    }
+};
+
+///=============================================================================
+/// Applies a user-supplied "placed before" predicate to projected elements:
+/// comp(proj(lhs), proj(rhs)).
+///=============================================================================
+template <typename Compare, typename Projection>
+struct ProjectedBefore
+{
+    Compare    comp;
+    Projection proj;
+
+    template <typename U>
+    constexpr bool operator()(const U& lhs, const U& rhs) const
+    {
+        return comp(proj(lhs), proj(rhs));
+    }
+};
+
+///=============================================================================
+/// @brief Builds ProjectedBefore from a comparator and a projection.
 ///=============================================================================
-template <typename T, size_t SIZE>
-class SortingCore
+template <typename Compare, typename Projection>
+constexpr ProjectedBefore<Compare, Projection> makeProjectedBefore(Compare comp,
+                                                                   Projection proj)
 {
+    return ProjectedBefore<Compare, Projection>{ comp, proj };
+}
 
+///=============================================================================
+/// Size marker for engines which work over a caller-owned buffer whose length
+/// is known only at runtime (like std::dynamic_extent for std::span).
+///=============================================================================
+constexpr std::size_t DYNAMIC_SIZE = static_cast<std::size_t>(-1);
+
+///=============================================================================
+/// Iterators known to walk a single array of T: raw pointers and the iterators
+/// of std::vector<T> (except std::vector<bool>, which packs bits). Being
+/// random-access is not enough: std::deque<T> iterators are random-access too,
+/// but its elements live in separate blocks.
+///=============================================================================
+template <typename Iterator, typename T>
+struct IsContiguousIterator
+    : std::integral_constant<bool,
+                             std::is_same<Iterator, T*>::value
+                             || (!std::is_same<T, bool>::value
+                                 && std::is_same<Iterator, typename std::vector<T>::iterator>::value)>
+{};
+
+///=============================================================================
+/// Fixed-size storage. Input array is copied into the object, which makes it
+/// suitable for small compile-time arrays only.
+///=============================================================================
+template <typename T, std::size_t SIZE>
+class SortingStorage
+{
 public:
     ///=============================================================================
+    /// @brief Constructor. Copies SIZE elements of the input array.
+    ///
+    /// @param const T* inputArray - array of at least SIZE elements.
     ///=============================================================================
-    SortingCore(T* inputArray)
+    SortingStorage(const T* inputArray)
     {
-        static_assert(std::is_integral<T>::value, "Integral value is required.");
         std::memcpy(m_array, inputArray, SIZE * sizeof(T));
     }
 
+    ///=============================================================================
+    ///=============================================================================
+    T* data() noexcept { return m_array; }
+
+    ///=============================================================================
+    ///=============================================================================
+    const T* data() const noexcept { return m_array; }
+
+    ///=============================================================================
+    ///=============================================================================
+    std::size_t size() const noexcept { return SIZE; }
+
+protected:
+    T m_array[SIZE];
+};
+
+///=============================================================================
+/// Runtime-sized storage. Nothing is copied: the object is a view over a
+/// caller-owned contiguous buffer, which gets sorted in place. The buffer must
+/// outlive the object.
+///=============================================================================
+template <typename T>
+class SortingStorage<T, DYNAMIC_SIZE>
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor. Pointer + length.
+    ///
+    /// @param T* inputArray - caller-owned buffer.
+    /// @param const std::size_t size - number of elements in the buffer.
+    ///=============================================================================
+    SortingStorage(T* inputArray,
+                   const std::size_t size)
+        : m_array(inputArray)
+        , m_size(size)
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Range [first, last) of contiguous iterators: raw
+    ///        pointers or std::vector<T>::iterator (see IsContiguousIterator).
+    ///        Other containers, std::array included, go through the container
+    ///        constructor or data() and size().
+    ///
+    /// @param Iterator first - beginning of the range.
+    /// @param Iterator last - end of the range.
+    ///=============================================================================
+    template <typename Iterator,
+              typename = typename std::enable_if<IsContiguousIterator<Iterator, T>::value>::type>
+    SortingStorage(Iterator first,
+                   Iterator last)
+        : m_array(first == last ? nullptr : std::addressof(*first))
+        , m_size(static_cast<std::size_t>(last - first))
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Any contiguous container or view which provides data()
+    ///        and size(): std::vector, std::array, std::span and so on.
+    ///
+    /// @param Container& container - caller-owned container.
+    ///=============================================================================
+    template <typename Container,
+              typename = typename std::enable_if<std::is_same<
+                  decltype(std::declval<Container&>().data()), T*>::value>::type,
+              typename = decltype(std::declval<Container&>().size())>
+    explicit SortingStorage(Container& container)
+        : m_array(container.data())
+        , m_size(static_cast<std::size_t>(container.size()))
+    {}
+
+    ///=============================================================================
+    ///=============================================================================
+    T* data() noexcept { return m_array; }
+
+    ///=============================================================================
+    ///=============================================================================
+    const T* data() const noexcept { return m_array; }
+
+    ///=============================================================================
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_size; }
+
+protected:
+    T*          m_array;
+    std::size_t m_size;
+};
+
+///=============================================================================
+/// Base class of the sorting engines. SIZE is either a compile-time number of
+/// elements (the input is copied into the object) or DYNAMIC_SIZE (the object
+/// sorts a caller-owned buffer in place).
+///
+/// Example of usage with a runtime-sized buffer:
+/// std::vector<int> keys = loadKeys();
+/// QuickSort<int> qSort(keys);                  // or qSort(keys.data(), keys.size())
+/// qSort.sort();                                // keys are sorted, no copy made
+///
+/// sort(order) is the runtime-order entry point; it dispatches once to the
+/// engine's sort<ORDER>(), whose comparisons are resolved at compile time.
+/// sortBy(comp, proj) takes a user "placed before" predicate and a projection:
+/// qSort.sort<SortOrder::DESC>();
+/// qSort.sortBy(std::greater<int>());
+/// qSort.sortBy(std::less<int>(), [](const int key) { return key & 0xFF; });
+///=============================================================================
+template <typename T, std::size_t SIZE = DYNAMIC_SIZE>
+class SortingCore : public SortingStorage<T, SIZE>
+{
+    static_assert(std::is_integral<T>::value, "Integral value is required.");
+
+public:
+    using SortingStorage<T, SIZE>::SortingStorage;
+
     ///=============================================================================
     ///=============================================================================
     virtual ~SortingCore() {}
@@ -37,27 +233,57 @@ public:
     virtual void sort(const SortOrder order = SortOrder::ASC) = 0;
 
     ///=============================================================================
+    /// @brief Prints the elements to the standard output, each followed by a
+    ///        space, and a new line. The text is formatted into a local chunk
+    ///        which goes to std::cout in one write, not element by element.
+    ///
+    /// @return void.
     ///=============================================================================
     void print()
     {
-        for (const auto i : m_array)
+        // Most characters of an element and its space: sign and digits
+        const std::size_t ELEMENT_CHARS = std::numeric_limits<T>::digits10 + 3;
+        char chunk[4096];
+        std::size_t used = 0;
+        for (std::size_t i = 0; i < this->size(); ++i)
         {
-            std::cout << i << ' ';
+            if (used + ELEMENT_CHARS > sizeof(chunk))
+            {
+                std::cout.write(chunk, static_cast<std::streamsize>(used));
+                used = 0;
+            }
+            used = static_cast<std::size_t>(printElement(chunk + used, this->data()[i], PrintedAsCharacter()) - chunk);
+            chunk[used++] = ' ';
         }
-        std::cout << std::endl;
+        chunk[used++] = '\n';
+        std::cout.write(chunk, static_cast<std::streamsize>(used));
+        std::cout.flush();
     }
 
-protected:
-    T m_array[SIZE];
+    ///=============================================================================
+    /// @brief Writes the elements, each followed by a space, and a new line, in
+    ///        the text of std::cout: integers in decimal, characters as is,
+    ///        bool as 0 or 1.
+    ///
+    /// @param Writer& out - destination, a BufferedWriter (see
+    ///        IO\BufferedWriter.h) or alike.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Writer>
+    void print(Writer& out)
+    {
+        writeElements(out, PrintedAsCharacter());
+        out.write('\n');
+    }
 
+protected:
     ///=============================================================================
     ///=============================================================================
     void swap(T& element1,
               T& element2)
     {
-        T tmp{ std::move(element1) };
-        element1 = std::move(element2);
-        element2 = std::move(tmp);
+        SortingKernels::swapElements(element1, element2);
     }
 
     ///=============================================================================
@@ -75,6 +301,73 @@ protected:
             return element1 < element2;
         }
     }
+
+private:
+    // Elements which std::cout does not print as numbers (bool prints as 0/1)
+    using PrintedAsCharacter = std::integral_constant<bool, std::is_same<T, char>::value
+                                                          || std::is_same<T, signed char>::value
+                                                          || std::is_same<T, unsigned char>::value
+                                                          || std::is_same<T, bool>::value>;
+
+    ///=============================================================================
+    /// @brief Formats an integer in decimal at out.
+    ///
+    /// @return char* - end of the written characters.
+    ///=============================================================================
+    static char* printElement(char* out,
+                              const T element,
+                              std::false_type) noexcept
+    {
+        using Widest = typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type;
+        return std::to_chars(out, out + std::numeric_limits<T>::digits10 + 2, static_cast<Widest>(element)).ptr;
+    }
+
+    ///=============================================================================
+    /// @brief Writes a character element at out.
+    ///
+    /// @return char* - end of the written characters.
+    ///=============================================================================
+    static char* printElement(char* out,
+                              const T element,
+                              std::true_type) noexcept
+    {
+        *out = printedCharacter(element);
+        return out + 1;
+    }
+
+    ///=============================================================================
+    /// @brief Writes integers in decimal, formatted a chunk at a time.
+    ///=============================================================================
+    template <typename Writer>
+    void writeElements(Writer& out,
+                       std::false_type)
+    {
+        if (this->size() != 0)
+        {
+            out.writeNumbers(this->data(), this->size(), ' ');
+            out.write(' ');
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Writes the elements which std::cout does not print as numbers:
+    ///        the characters themselves, and bool as 0 or 1.
+    ///=============================================================================
+    template <typename Writer>
+    void writeElements(Writer& out,
+                       std::true_type)
+    {
+        for (std::size_t i = 0; i < this->size(); ++i)
+        {
+            out.write(printedCharacter(this->data()[i]));
+            out.write(' ');
+        }
+    }
+
+    static char printedCharacter(const char c) noexcept { return c; }
+    static char printedCharacter(const signed char c) noexcept { return static_cast<char>(c); }
+    static char printedCharacter(const unsigned char c) noexcept { return static_cast<char>(c); }
+    static char printedCharacter(const bool b) noexcept { return b ? '1' : '0'; }
 };
 
 #endif // SORTINGCORE_H
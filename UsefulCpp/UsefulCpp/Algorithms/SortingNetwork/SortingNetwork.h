@@ -0,0 +1,619 @@
+#ifndef SORTINGNETWORK_H
+#define SORTINGNETWORK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "..\SortingCore.h"
+#include "..\..\Platform\CpuFeatures.h"
+
+#if defined(USEFULCPP_X86)
+    #define SORTING_NETWORK_X86
+    #define SORTING_NETWORK_AVX2 USEFULCPP_TARGET_AVX2
+    #define SORTING_NETWORK_SSE41 USEFULCPP_TARGET_SSE41
+#endif
+
+///=============================================================================
+/// Bitonic sorting networks for small blocks (8, 16, 32 and 64 elements) of
+/// integral keys. Networks have a fixed sequence of compare-exchanges, so they
+/// do not mispredict and map onto SIMD min/max instructions.
+///
+/// 8-, 16- and 32-bit keys use AVX2 kernels when the CPU supports them, SSE4.1
+/// kernels otherwise (checked once at runtime). 64-bit keys and CPUs without
+/// SSE4.1 run the scalar network, whose min/max compare-exchanges compile to
+/// conditional moves; there is no 64-bit min/max before AVX-512.
+///
+/// The "flip" form of the bitonic network is used: merging two sorted halves of
+/// a block of k elements starts with comparing i with k - 1 - i, followed by the
+/// half-cleaners at distances k/4, k/8 ... 1. All the comparators are ascending.
+///=============================================================================
+namespace SortingKernels
+{
+    // Largest block sorted by the networks
+    constexpr std::size_t NETWORK_MAX_SIZE = 64;
+
+    // Smallest block, equals to the number of 32-bit lanes of an AVX2 register.
+    // Narrower keys are padded up to a whole register (see networkSort()).
+    constexpr std::size_t NETWORK_MIN_SIZE = 8;
+
+    ///=============================================================================
+    /// @brief Branchless compare-exchange: a gets the minimum, b the maximum.
+    ///=============================================================================
+    template <typename T>
+    inline void compareExchange(T& a,
+                                T& b)
+    {
+        const T low = std::min(a, b);
+        b = std::max(a, b);
+        a = low;
+    }
+
+    ///=============================================================================
+    /// @brief Scalar bitonic network, sorts the block in ascending order.
+    ///
+    /// @param T* block - block of SIZE elements.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <std::size_t SIZE, typename T>
+    void scalarBitonicSort(T* block)
+    {
+        for (std::size_t k = 2; k <= SIZE; k *= 2)
+        {
+            for (std::size_t i = 0; i < SIZE; ++i)
+            {
+                const std::size_t mirror = i ^ (k - 1);
+                if (mirror > i)
+                {
+                    compareExchange(block[i], block[mirror]);
+                }
+            }
+            for (std::size_t distance = k / 4; distance > 0; distance /= 2)
+            {
+                for (std::size_t i = 0; i < SIZE; ++i)
+                {
+                    if ((i & distance) == 0)
+                    {
+                        compareExchange(block[i], block[i + distance]);
+                    }
+                }
+            }
+        }
+    }
+
+#if defined(SORTING_NETWORK_X86)
+    ///=============================================================================
+    /// Min/max of eight 32-bit lanes of the given signedness.
+    ///=============================================================================
+    template <bool SIGNED>
+    struct Avx2Lanes32
+    {
+        SORTING_NETWORK_AVX2 static __m256i min(const __m256i a, const __m256i b)
+        {
+            return _mm256_min_epi32(a, b);
+        }
+
+        SORTING_NETWORK_AVX2 static __m256i max(const __m256i a, const __m256i b)
+        {
+            return _mm256_max_epi32(a, b);
+        }
+    };
+
+    template <>
+    struct Avx2Lanes32<false>
+    {
+        SORTING_NETWORK_AVX2 static __m256i min(const __m256i a, const __m256i b)
+        {
+            return _mm256_min_epu32(a, b);
+        }
+
+        SORTING_NETWORK_AVX2 static __m256i max(const __m256i a, const __m256i b)
+        {
+            return _mm256_max_epu32(a, b);
+        }
+    };
+
+    ///=============================================================================
+    /// @brief Reverses the eight lanes of a register.
+    ///=============================================================================
+    SORTING_NETWORK_AVX2 inline __m256i avx2Reverse32(const __m256i v)
+    {
+        return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    ///=============================================================================
+    /// @brief One in-register stage: lanes selected by MASK take the maximum of
+    ///        themselves and their partner from the permuted register.
+    ///=============================================================================
+    template <bool SIGNED, int MASK>
+    SORTING_NETWORK_AVX2 inline __m256i avx2Stage32(const __m256i v,
+                                                    const __m256i partner)
+    {
+        return _mm256_blend_epi32(Avx2Lanes32<SIGNED>::min(v, partner),
+                                  Avx2Lanes32<SIGNED>::max(v, partner), MASK);
+    }
+
+    ///=============================================================================
+    /// @brief Half-cleaners at distances 4, 2 and 1: sorts a bitonic register.
+    ///=============================================================================
+    template <bool SIGNED>
+    SORTING_NETWORK_AVX2 inline __m256i avx2Clean32(__m256i v)
+    {
+        v = avx2Stage32<SIGNED, 0xF0>(v, _mm256_permute2x128_si256(v, v, 0x01));
+        v = avx2Stage32<SIGNED, 0xCC>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = avx2Stage32<SIGNED, 0xAA>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return v;
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the eight lanes of a register.
+    ///=============================================================================
+    template <bool SIGNED>
+    SORTING_NETWORK_AVX2 inline __m256i avx2Sort8x32(__m256i v)
+    {
+        // k = 2
+        v = avx2Stage32<SIGNED, 0xAA>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        // k = 4
+        v = avx2Stage32<SIGNED, 0xCC>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)));
+        v = avx2Stage32<SIGNED, 0xAA>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        // k = 8
+        v = avx2Stage32<SIGNED, 0xF0>(v, avx2Reverse32(v));
+        v = avx2Stage32<SIGNED, 0xCC>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = avx2Stage32<SIGNED, 0xAA>(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return v;
+    }
+
+    ///=============================================================================
+    /// @brief AVX2 bitonic network over a block of 32-bit keys, ascending order.
+    ///
+    /// @param void* block - block of SIZE 32-bit keys.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <std::size_t SIZE, bool SIGNED>
+    SORTING_NETWORK_AVX2 void avx2BitonicSort32(void* block)
+    {
+        constexpr std::size_t REGISTERS = SIZE / 8;
+        using Lanes = Avx2Lanes32<SIGNED>;
+
+        __m256i* memory = static_cast<__m256i*>(block);
+        __m256i r[REGISTERS];
+        for (std::size_t i = 0; i < REGISTERS; ++i)
+        {
+            r[i] = avx2Sort8x32<SIGNED>(_mm256_loadu_si256(memory + i));
+        }
+
+        for (std::size_t merged = 2; merged <= REGISTERS; merged *= 2)
+        {
+            for (std::size_t base = 0; base < REGISTERS; base += merged)
+            {
+                // Flip stage: i against k - 1 - i
+                for (std::size_t i = 0; i < merged / 2; ++i)
+                {
+                    const __m256i low = r[base + i];
+                    const __m256i high = avx2Reverse32(r[base + merged - 1 - i]);
+                    r[base + i] = Lanes::min(low, high);
+                    r[base + merged - 1 - i] = avx2Reverse32(Lanes::max(low, high));
+                }
+                // Half-cleaners between registers
+                for (std::size_t distance = merged / 4; distance > 0; distance /= 2)
+                {
+                    for (std::size_t i = base; i < base + merged; ++i)
+                    {
+                        if (((i - base) & distance) == 0)
+                        {
+                            const __m256i low = r[i];
+                            r[i] = Lanes::min(low, r[i + distance]);
+                            r[i + distance] = Lanes::max(low, r[i + distance]);
+                        }
+                    }
+                }
+                // Half-cleaners inside registers
+                for (std::size_t i = base; i < base + merged; ++i)
+                {
+                    r[i] = avx2Clean32<SIGNED>(r[i]);
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < REGISTERS; ++i)
+        {
+            _mm256_storeu_si256(memory + i, r[i]);
+        }
+    }
+
+    ///=============================================================================
+    /// Registers of the generic network below, for lanes of any width. Lanes are
+    /// addressed through their bytes: the partner of the lane at distance d (or
+    /// the mirror of a group of d lanes) is the byte index XOR d * width, which
+    /// a byte shuffle does for every width.
+    ///
+    /// - permute(v, xorBytes) - byte j takes byte j ^ xorBytes.
+    /// - select(a, b, bytes)  - bytes j with (j & bytes) != 0 come from b.
+    /// - stage(v, xorBytes, maskBytes) - compare-exchange with the permuted
+    ///   register, the lanes selected by maskBytes keep the maximum.
+    /// - exchange(low, high) - low keeps the minimums, high the maximums.
+    ///
+    /// The generic network is not compiled for the target (only its entries
+    /// are), and is not inlined into them in unoptimized builds: registers
+    /// cross its calls by reference only, never by value or as a result, so
+    /// that the calls do not depend on the AVX calling convention.
+    ///=============================================================================
+    struct Avx2Network
+    {
+        using Register = __m256i;
+        static constexpr std::size_t BYTES = 32;
+
+        SORTING_NETWORK_AVX2 static void load(Register& v,
+                                              const void* memory)
+        {
+            v = _mm256_loadu_si256(static_cast<const __m256i*>(memory));
+        }
+
+        SORTING_NETWORK_AVX2 static void store(void* memory,
+                                               const Register& v)
+        {
+            _mm256_storeu_si256(static_cast<__m256i*>(memory), v);
+        }
+
+        SORTING_NETWORK_AVX2 static void permute(Register& v,
+                                                 std::size_t xorBytes)
+        {
+            if (xorBytes >= 16)
+            {
+                v = _mm256_permute2x128_si256(v, v, 0x01);
+                xorBytes -= 16;
+            }
+            if (xorBytes != 0)
+            {
+                const __m256i indices = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                         0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+                v = _mm256_shuffle_epi8(v, _mm256_xor_si256(indices, _mm256_set1_epi8(static_cast<char>(xorBytes))));
+            }
+        }
+
+        SORTING_NETWORK_AVX2 static Register select(const Register a,
+                                                    const Register b,
+                                                    const std::size_t bytes)
+        {
+            const __m256i indices = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                     16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+            const __m256i bit = _mm256_set1_epi8(static_cast<char>(bytes));
+            return _mm256_blendv_epi8(a, b, _mm256_cmpeq_epi8(_mm256_and_si256(indices, bit), bit));
+        }
+
+        template <typename Lanes>
+        SORTING_NETWORK_AVX2 static void stage(Register& v,
+                                               const std::size_t xorBytes,
+                                               const std::size_t maskBytes)
+        {
+            Register partner = v;
+            permute(partner, xorBytes);
+            v = select(Lanes::min(v, partner), Lanes::max(v, partner), maskBytes);
+        }
+
+        template <typename Lanes>
+        SORTING_NETWORK_AVX2 static void exchange(Register& low,
+                                                  Register& high)
+        {
+            const Register minimum = Lanes::min(low, high);
+            high = Lanes::max(low, high);
+            low = minimum;
+        }
+    };
+
+    struct Sse41Network
+    {
+        using Register = __m128i;
+        static constexpr std::size_t BYTES = 16;
+
+        SORTING_NETWORK_SSE41 static void load(Register& v,
+                                               const void* memory)
+        {
+            v = _mm_loadu_si128(static_cast<const __m128i*>(memory));
+        }
+
+        SORTING_NETWORK_SSE41 static void store(void* memory,
+                                                const Register& v)
+        {
+            _mm_storeu_si128(static_cast<__m128i*>(memory), v);
+        }
+
+        SORTING_NETWORK_SSE41 static void permute(Register& v,
+                                                  const std::size_t xorBytes)
+        {
+            const __m128i indices = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            v = _mm_shuffle_epi8(v, _mm_xor_si128(indices, _mm_set1_epi8(static_cast<char>(xorBytes))));
+        }
+
+        SORTING_NETWORK_SSE41 static Register select(const Register a,
+                                                     const Register b,
+                                                     const std::size_t bytes)
+        {
+            const __m128i indices = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m128i bit = _mm_set1_epi8(static_cast<char>(bytes));
+            return _mm_blendv_epi8(a, b, _mm_cmpeq_epi8(_mm_and_si128(indices, bit), bit));
+        }
+
+        template <typename Lanes>
+        SORTING_NETWORK_SSE41 static void stage(Register& v,
+                                                const std::size_t xorBytes,
+                                                const std::size_t maskBytes)
+        {
+            Register partner = v;
+            permute(partner, xorBytes);
+            v = select(Lanes::min(v, partner), Lanes::max(v, partner), maskBytes);
+        }
+
+        template <typename Lanes>
+        SORTING_NETWORK_SSE41 static void exchange(Register& low,
+                                                   Register& high)
+        {
+            const Register minimum = Lanes::min(low, high);
+            high = Lanes::max(low, high);
+            low = minimum;
+        }
+    };
+
+    ///=============================================================================
+    /// Min/max of the lanes of WIDTH bytes and the given signedness.
+    ///=============================================================================
+    template <typename Network, std::size_t WIDTH, bool SIGNED>
+    struct NetworkLanes;
+
+#define SORTING_NETWORK_LANES(NETWORK, WIDTH, SIGNED, TARGET, MIN, MAX)                  \
+    template <>                                                                          \
+    struct NetworkLanes<NETWORK, WIDTH, SIGNED>                                          \
+    {                                                                                    \
+        TARGET static NETWORK::Register min(const NETWORK::Register a,                   \
+                                            const NETWORK::Register b) { return MIN(a, b); } \
+        TARGET static NETWORK::Register max(const NETWORK::Register a,                   \
+                                            const NETWORK::Register b) { return MAX(a, b); } \
+    };
+
+    SORTING_NETWORK_LANES(Avx2Network, 1, true,  SORTING_NETWORK_AVX2, _mm256_min_epi8,  _mm256_max_epi8)
+    SORTING_NETWORK_LANES(Avx2Network, 1, false, SORTING_NETWORK_AVX2, _mm256_min_epu8,  _mm256_max_epu8)
+    SORTING_NETWORK_LANES(Avx2Network, 2, true,  SORTING_NETWORK_AVX2, _mm256_min_epi16, _mm256_max_epi16)
+    SORTING_NETWORK_LANES(Avx2Network, 2, false, SORTING_NETWORK_AVX2, _mm256_min_epu16, _mm256_max_epu16)
+    SORTING_NETWORK_LANES(Avx2Network, 4, true,  SORTING_NETWORK_AVX2, _mm256_min_epi32, _mm256_max_epi32)
+    SORTING_NETWORK_LANES(Avx2Network, 4, false, SORTING_NETWORK_AVX2, _mm256_min_epu32, _mm256_max_epu32)
+    SORTING_NETWORK_LANES(Sse41Network, 1, true,  SORTING_NETWORK_SSE41, _mm_min_epi8,  _mm_max_epi8)
+    SORTING_NETWORK_LANES(Sse41Network, 1, false, SORTING_NETWORK_SSE41, _mm_min_epu8,  _mm_max_epu8)
+    SORTING_NETWORK_LANES(Sse41Network, 2, true,  SORTING_NETWORK_SSE41, _mm_min_epi16, _mm_max_epi16)
+    SORTING_NETWORK_LANES(Sse41Network, 2, false, SORTING_NETWORK_SSE41, _mm_min_epu16, _mm_max_epu16)
+    SORTING_NETWORK_LANES(Sse41Network, 4, true,  SORTING_NETWORK_SSE41, _mm_min_epi32, _mm_max_epi32)
+    SORTING_NETWORK_LANES(Sse41Network, 4, false, SORTING_NETWORK_SSE41, _mm_min_epu32, _mm_max_epu32)
+
+#undef SORTING_NETWORK_LANES
+
+    ///=============================================================================
+    /// @brief Bitonic network over a block of keys of WIDTH bytes, ascending
+    ///        order, for any Network above. Each register is sorted first, then
+    ///        the registers are merged like in avx2BitonicSort32().
+    ///
+    /// @param void* block - block of SIZE keys, SIZE * WIDTH a multiple of the
+    ///        register size.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Network, std::size_t SIZE, std::size_t WIDTH, bool SIGNED>
+    void vectorBitonicSort(void* block)
+    {
+        using Register = typename Network::Register;
+        using Lanes = NetworkLanes<Network, WIDTH, SIGNED>;
+        constexpr std::size_t LANES = Network::BYTES / WIDTH;
+        constexpr std::size_t REGISTERS = SIZE / LANES;
+        // Mirror of the whole register: reverses the lanes
+        constexpr std::size_t REVERSE = Network::BYTES - WIDTH;
+        static_assert(REGISTERS > 0 && SIZE % LANES == 0, "Block does not fill whole registers.");
+
+        char* memory = static_cast<char*>(block);
+        Register r[REGISTERS];
+        for (std::size_t i = 0; i < REGISTERS; ++i)
+        {
+            Network::load(r[i], memory + i * Network::BYTES);
+            for (std::size_t k = 2; k <= LANES; k *= 2)
+            {
+                Network::template stage<Lanes>(r[i], (k - 1) * WIDTH, k / 2 * WIDTH);
+                for (std::size_t distance = k / 4; distance > 0; distance /= 2)
+                {
+                    Network::template stage<Lanes>(r[i], distance * WIDTH, distance * WIDTH);
+                }
+            }
+        }
+
+        for (std::size_t merged = 2; merged <= REGISTERS; merged *= 2)
+        {
+            for (std::size_t base = 0; base < REGISTERS; base += merged)
+            {
+                // Flip stage: i against k - 1 - i
+                for (std::size_t i = 0; i < merged / 2; ++i)
+                {
+                    Register& high = r[base + merged - 1 - i];
+                    Network::permute(high, REVERSE);
+                    Network::template exchange<Lanes>(r[base + i], high);
+                    Network::permute(high, REVERSE);
+                }
+                // Half-cleaners between registers
+                for (std::size_t distance = merged / 4; distance > 0; distance /= 2)
+                {
+                    for (std::size_t i = base; i < base + merged; ++i)
+                    {
+                        if (((i - base) & distance) == 0)
+                        {
+                            Network::template exchange<Lanes>(r[i], r[i + distance]);
+                        }
+                    }
+                }
+                // Half-cleaners inside registers
+                for (std::size_t i = base; i < base + merged; ++i)
+                {
+                    for (std::size_t distance = LANES / 2; distance > 0; distance /= 2)
+                    {
+                        Network::template stage<Lanes>(r[i], distance * WIDTH, distance * WIDTH);
+                    }
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < REGISTERS; ++i)
+        {
+            Network::store(memory + i * Network::BYTES, r[i]);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief AVX2 entry of the generic network. 32-bit keys go to
+    ///        avx2BitonicSort32(), whose shuffles take immediates.
+    ///=============================================================================
+    template <std::size_t SIZE, std::size_t WIDTH, bool SIGNED>
+    SORTING_NETWORK_AVX2 USEFULCPP_FLATTEN void avx2BitonicSort(void* block)
+    {
+        vectorBitonicSort<Avx2Network, SIZE, WIDTH, SIGNED>(block);
+    }
+
+    ///=============================================================================
+    /// @brief SSE4.1 entry of the generic network (8-, 16- and 32-bit keys).
+    ///=============================================================================
+    template <std::size_t SIZE, std::size_t WIDTH, bool SIGNED>
+    SORTING_NETWORK_SSE41 USEFULCPP_FLATTEN void sse41BitonicSort(void* block)
+    {
+        vectorBitonicSort<Sse41Network, SIZE, WIDTH, SIGNED>(block);
+    }
+#endif // SORTING_NETWORK_X86
+
+    ///=============================================================================
+    /// @brief Gets the number of lanes of the vector network for keys of type T on
+    ///        this CPU, 0 if there is none. Blocks passed to bitonicSortBlock()
+    ///        must have at least that many keys.
+    ///
+    /// @return std::size_t - number of keys per register.
+    ///=============================================================================
+    template <typename T>
+    inline std::size_t vectorNetworkLanes()
+    {
+#if defined(SORTING_NETWORK_X86)
+        if (sizeof(T) <= 4 && cpuSupportsAvx2())
+        {
+            return 32 / sizeof(T);
+        }
+        if (sizeof(T) <= 4 && cpuSupportsSse41())
+        {
+            return 16 / sizeof(T);
+        }
+#endif
+        return 0;
+    }
+
+    ///=============================================================================
+    /// @brief Sorts a block of exactly SIZE elements in ascending order, picking
+    ///        the AVX2 or the scalar network.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <std::size_t SIZE, typename T>
+    void bitonicSortBlock(T* block)
+    {
+        static_assert(SIZE >= NETWORK_MIN_SIZE && SIZE <= NETWORK_MAX_SIZE &&
+                      (SIZE & (SIZE - 1)) == 0, "Unsupported block size.");
+#if defined(SORTING_NETWORK_X86)
+        // Key width and block size as seen by the vector kernels. The clamps only
+        // keep the unused instantiations valid: the branches check the real ones.
+        constexpr bool SIGNED = std::is_signed<T>::value;
+        constexpr std::size_t WIDTH = sizeof(T) <= 4 ? sizeof(T) : 4;
+        constexpr std::size_t AVX2_SIZE = SIZE * WIDTH >= 32 ? SIZE : 32 / WIDTH;
+        constexpr std::size_t SSE41_SIZE = SIZE * WIDTH >= 16 ? SIZE : 16 / WIDTH;
+        if (sizeof(T) <= 4 && cpuSupportsAvx2())
+        {
+            if (sizeof(T) == 4)
+            {
+                avx2BitonicSort32<SIZE, SIGNED>(block);
+                return;
+            }
+            if (SIZE * sizeof(T) >= 32)
+            {
+                avx2BitonicSort<AVX2_SIZE, WIDTH, SIGNED>(block);
+                return;
+            }
+        }
+        if (sizeof(T) <= 4 && SIZE * sizeof(T) >= 16 && cpuSupportsSse41())
+        {
+            sse41BitonicSort<SSE41_SIZE, WIDTH, SIGNED>(block);
+            return;
+        }
+#endif
+        scalarBitonicSort<SIZE>(block);
+    }
+
+    ///=============================================================================
+    /// @brief Checks whether networkSort() runs a vector kernel for keys of type T
+    ///        on this CPU. The scalar network is slower than insertion sort, so
+    ///        callers use the networks as a base case only when this is true.
+    ///
+    /// @return true if a SIMD kernel is available.
+    ///=============================================================================
+    template <typename T>
+    inline bool hasVectorNetwork()
+    {
+        return vectorNetworkLanes<T>() != 0;
+    }
+
+    ///=============================================================================
+    /// @brief Sorts up to NETWORK_MAX_SIZE elements with a sorting network. The
+    ///        range is padded with sentinels up to the next block size.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range, (last - first) <= NETWORK_MAX_SIZE.
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T>
+    void networkSort(T* first,
+                     T* last,
+                     const SortOrder order = SortOrder::ASC)
+    {
+        static_assert(std::is_integral<T>::value, "Integral value is required.");
+
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size < 2)
+        {
+            return;
+        }
+
+        // Narrow keys fill at least one register
+        const std::size_t lanes = vectorNetworkLanes<T>();
+        std::size_t blockSize = lanes > NETWORK_MIN_SIZE ? lanes : NETWORK_MIN_SIZE;
+        while (blockSize < size)
+        {
+            blockSize *= 2;
+        }
+
+        T block[NETWORK_MAX_SIZE];
+        std::copy(first, last, block);
+        std::fill(block + size, block + blockSize, std::numeric_limits<T>::max());
+
+        switch (blockSize)
+        {
+        case 8:  bitonicSortBlock<8>(block);  break;
+        case 16: bitonicSortBlock<16>(block); break;
+        case 32: bitonicSortBlock<32>(block); break;
+        default: bitonicSortBlock<64>(block); break;
+        }
+
+        // Sentinels are the largest keys, they stay behind the first size elements
+        if (order == SortOrder::ASC)
+        {
+            std::copy(block, block + size, first);
+        }
+        else
+        {
+            std::reverse_copy(block, block + size, first);
+        }
+    }
+}
+
+#endif // SORTINGNETWORK_H
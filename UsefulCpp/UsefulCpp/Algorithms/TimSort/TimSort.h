@@ -0,0 +1,533 @@
+#ifndef TIMSORT_H
+#define TIMSORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "..\SortingCore.h"
+#include "..\QuickSort\IntroSort.h"
+
+///=============================================================================
+/// Building blocks of an adaptive stable merge sort in the TimSort family:
+/// the input is split into natural runs (strictly descending runs are
+/// reversed, short runs are extended by insertion sort up to minRun), and the
+/// runs are merged in the order chosen by the "powersort" policy (Munro, Wild,
+/// 2018), which is provably within O(n) of the optimal merge cost for the run
+/// lengths at hand. Merges gallop (exponential search) once one side keeps
+/// winning, so long runs interleaving little are merged in sublinear
+/// comparisons.
+///
+/// All kernels take a predicate comp(lhs, rhs) which returns true if lhs must
+/// be placed before rhs (like std::less). Equal elements keep their order.
+///
+/// Guarantees: O(n log n) worst case, O(n) on presorted input (a few runs),
+/// scratch memory for n / 2 elements.
+///=============================================================================
+namespace SortingKernels
+{
+    // One side winning this many times in a row switches the merge to galloping
+    constexpr std::size_t MIN_GALLOP = 7;
+
+    // Natural runs shorter than minRun (32..64) are extended by insertion sort
+    constexpr std::size_t MIN_MERGE = 64;
+
+    ///=============================================================================
+    /// @brief Computes the minimal run length, so that n / minRun is equal to or
+    ///        slightly less than a power of 2 (as in TimSort).
+    ///
+    /// @param std::size_t size - number of elements.
+    ///
+    /// @return std::size_t - minimal run length.
+    ///=============================================================================
+    inline std::size_t timSortMinRun(std::size_t size)
+    {
+        std::size_t lowBits = 0;
+        while (size >= MIN_MERGE)
+        {
+            lowBits |= size & 1;
+            size >>= 1;
+        }
+        return size + lowBits;
+    }
+
+    ///=============================================================================
+    /// @brief Finds the natural run at the beginning of the range and makes it
+    ///        ascending. Only strictly descending runs are reversed, so equal
+    ///        elements never swap their order.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return std::size_t - length of the run.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    std::size_t countRunAndMakeAscending(T* first,
+                                         T* last,
+                                         Compare comp)
+    {
+        T* runEnd = first + 1;
+        if (runEnd >= last)
+        {
+            return static_cast<std::size_t>(last - first);
+        }
+
+        if (comp(*runEnd, *first))
+        {
+            while (++runEnd < last && comp(*runEnd, *(runEnd - 1))) {}
+            std::reverse(first, runEnd);
+        }
+        else
+        {
+            while (++runEnd < last && !comp(*runEnd, *(runEnd - 1))) {}
+        }
+        return static_cast<std::size_t>(runEnd - first);
+    }
+
+    ///=============================================================================
+    /// @brief Exponential search from the beginning: index of the first element
+    ///        for which pred holds. pred must be false...false true...true.
+    ///
+    /// @return std::size_t - index in [0, size].
+    ///=============================================================================
+    template <typename T, typename Predicate>
+    std::size_t gallopFromStart(T* base,
+                                const std::size_t size,
+                                Predicate pred)
+    {
+        if (size == 0 || pred(base[0]))
+        {
+            return 0;
+        }
+        // pred(base[last]) is false, pred(base[offset]) is true or offset is out
+        std::size_t last = 0;
+        std::size_t offset = 1;
+        while (offset < size && !pred(base[offset]))
+        {
+            last = offset;
+            offset = 2 * offset + 1;
+        }
+        offset = std::min(offset, size);
+        return static_cast<std::size_t>(std::partition_point(base + last + 1, base + offset,
+            [&pred](const T& element) { return !pred(element); }) - base);
+    }
+
+    ///=============================================================================
+    /// @brief Exponential search from the end: index of the first element for
+    ///        which pred holds. pred must be false...false true...true.
+    ///
+    /// @return std::size_t - index in [0, size].
+    ///=============================================================================
+    template <typename T, typename Predicate>
+    std::size_t gallopFromEnd(T* base,
+                              const std::size_t size,
+                              Predicate pred)
+    {
+        if (size == 0 || !pred(base[size - 1]))
+        {
+            return size;
+        }
+        // pred(base[size - 1 - last]) is true, pred(base[size - 1 - offset]) is false or offset is out
+        std::size_t last = 0;
+        std::size_t offset = 1;
+        while (offset < size && pred(base[size - 1 - offset]))
+        {
+            last = offset;
+            offset = 2 * offset + 1;
+        }
+        offset = std::min(offset, size);
+        return static_cast<std::size_t>(std::partition_point(base + (size - offset), base + (size - 1 - last),
+            [&pred](const T& element) { return !pred(element); }) - base);
+    }
+
+    ///=============================================================================
+    /// @brief Merges [first, middle) and [middle, last) when the left run is the
+    ///        shorter one: the left run goes to the buffer and the merge goes
+    ///        forward.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void mergeLow(T* first,
+                  T* middle,
+                  T* last,
+                  T* buffer,
+                  Compare comp)
+    {
+        T* left = buffer;
+        T* leftEnd = std::move(first, middle, buffer);
+        T* right = middle;
+        T* destination = first;
+
+        while (left < leftEnd && right < last)
+        {
+            // One element at a time until a side keeps winning
+            std::size_t leftWins = 0;
+            std::size_t rightWins = 0;
+            while (left < leftEnd && right < last && leftWins < MIN_GALLOP && rightWins < MIN_GALLOP)
+            {
+                if (comp(*right, *left))
+                {
+                    *destination++ = std::move(*right++);
+                    ++rightWins;
+                    leftWins = 0;
+                }
+                else
+                {
+                    *destination++ = std::move(*left++);
+                    ++leftWins;
+                    rightWins = 0;
+                }
+            }
+
+            // Galloping: whole blocks are moved while they stay long
+            std::size_t leftBlock = MIN_GALLOP;
+            std::size_t rightBlock = MIN_GALLOP;
+            while (left < leftEnd && right < last && (leftBlock >= MIN_GALLOP || rightBlock >= MIN_GALLOP))
+            {
+                const T& rightKey = *right;
+                leftBlock = gallopFromStart(left, static_cast<std::size_t>(leftEnd - left),
+                    [&comp, &rightKey](const T& element) { return comp(rightKey, element); });
+                destination = std::move(left, left + leftBlock, destination);
+                left += leftBlock;
+                if (left == leftEnd)
+                {
+                    break;
+                }
+                *destination++ = std::move(*right++);
+                if (right == last)
+                {
+                    break;
+                }
+
+                const T& leftKey = *left;
+                rightBlock = gallopFromStart(right, static_cast<std::size_t>(last - right),
+                    [&comp, &leftKey](const T& element) { return !comp(element, leftKey); });
+                destination = std::move(right, right + rightBlock, destination);
+                right += rightBlock;
+                *destination++ = std::move(*left++);
+            }
+        }
+        // The rest of the right run is already in place
+        std::move(left, leftEnd, destination);
+    }
+
+    ///=============================================================================
+    /// @brief Merges [first, middle) and [middle, last) when the right run is the
+    ///        shorter one: the right run goes to the buffer and the merge goes
+    ///        backward.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void mergeHigh(T* first,
+                   T* middle,
+                   T* last,
+                   T* buffer,
+                   Compare comp)
+    {
+        T* left = middle;
+        T* right = std::move(middle, last, buffer);
+        T* destination = last;
+
+        while (left > first && right > buffer)
+        {
+            std::size_t leftWins = 0;
+            std::size_t rightWins = 0;
+            while (left > first && right > buffer && leftWins < MIN_GALLOP && rightWins < MIN_GALLOP)
+            {
+                if (comp(*(right - 1), *(left - 1)))
+                {
+                    *--destination = std::move(*--left);
+                    ++leftWins;
+                    rightWins = 0;
+                }
+                else
+                {
+                    *--destination = std::move(*--right);
+                    ++rightWins;
+                    leftWins = 0;
+                }
+            }
+
+            std::size_t leftBlock = MIN_GALLOP;
+            std::size_t rightBlock = MIN_GALLOP;
+            while (left > first && right > buffer && (leftBlock >= MIN_GALLOP || rightBlock >= MIN_GALLOP))
+            {
+                // Left elements placed after the last right one
+                const T& rightKey = *(right - 1);
+                const std::size_t leftSize = static_cast<std::size_t>(left - first);
+                leftBlock = leftSize - gallopFromEnd(first, leftSize,
+                    [&comp, &rightKey](const T& element) { return comp(rightKey, element); });
+                destination = std::move_backward(left - leftBlock, left, destination);
+                left -= leftBlock;
+                if (left == first)
+                {
+                    break;
+                }
+                *--destination = std::move(*--right);
+                if (right == buffer)
+                {
+                    break;
+                }
+
+                // Right elements not placed before the last left one
+                const T& leftKey = *(left - 1);
+                const std::size_t rightSize = static_cast<std::size_t>(right - buffer);
+                rightBlock = rightSize - gallopFromEnd(buffer, rightSize,
+                    [&comp, &leftKey](const T& element) { return !comp(element, leftKey); });
+                destination = std::move_backward(right - rightBlock, right, destination);
+                right -= rightBlock;
+                *--destination = std::move(*--left);
+            }
+        }
+        // The rest of the left run is already in place
+        std::move(buffer, right, destination - (right - buffer));
+    }
+
+    ///=============================================================================
+    /// @brief Merges two adjacent ascending runs. Elements which are already in
+    ///        their final place at both ends are skipped by galloping first.
+    ///
+    /// @param T* first - beginning of the left run.
+    /// @param T* middle - end of the left run, beginning of the right one.
+    /// @param T* last - end of the right run.
+    /// @param T* buffer - scratch for the shorter run.
+    /// @param Compare comp - "placed before" predicate.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void mergeRuns(T* first,
+                   T* middle,
+                   T* last,
+                   T* buffer,
+                   Compare comp)
+    {
+        const T& rightFirst = *middle;
+        first += gallopFromStart(first, static_cast<std::size_t>(middle - first),
+            [&comp, &rightFirst](const T& element) { return comp(rightFirst, element); });
+        if (first == middle)
+        {
+            return;
+        }
+        const T& leftLast = *(middle - 1);
+        last = middle + gallopFromEnd(middle, static_cast<std::size_t>(last - middle),
+            [&comp, &leftLast](const T& element) { return !comp(element, leftLast); });
+        if (middle == last)
+        {
+            return;
+        }
+
+        if (middle - first <= last - middle)
+        {
+            mergeLow(first, middle, last, buffer, comp);
+        }
+        else
+        {
+            mergeHigh(first, middle, last, buffer, comp);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Powersort node power of the boundary between two adjacent runs: the
+    ///        depth at which the boundary splits [0, size) in a perfectly balanced
+    ///        merge tree.
+    ///
+    /// @param const std::size_t size - number of elements in the whole range.
+    /// @param const std::size_t leftBegin - position of the left run.
+    /// @param const std::size_t leftSize - length of the left run.
+    /// @param const std::size_t rightSize - length of the right run.
+    ///
+    /// @return unsigned int - power of the boundary.
+    ///=============================================================================
+    inline unsigned int powersortNodePower(const std::size_t size,
+                                           const std::size_t leftBegin,
+                                           const std::size_t leftSize,
+                                           const std::size_t rightSize)
+    {
+        // Doubled midpoints of the runs, compared bit by bit as fractions of size
+        std::size_t left = 2 * leftBegin + leftSize;
+        std::size_t right = left + leftSize + rightSize;
+        unsigned int power = 0;
+        for (;;)
+        {
+            ++power;
+            if (left >= size)
+            {
+                left -= size;
+                right -= size;
+            }
+            else if (right >= size)
+            {
+                break;
+            }
+            left <<= 1;
+            right <<= 1;
+        }
+        return power;
+    }
+
+    ///=============================================================================
+    /// @brief Adaptive stable sort of [first, last) with the powersort merge
+    ///        policy.
+    ///
+    /// @param T* first - beginning of the range.
+    /// @param T* last - end of the range.
+    /// @param Compare comp - "placed before" predicate.
+    /// @param T* buffer - scratch for at least (last - first) / 2 elements.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T, typename Compare>
+    void timSort(T* first,
+                 T* last,
+                 Compare comp,
+                 T* buffer)
+    {
+        struct Run
+        {
+            T*           begin;
+            std::size_t  size;
+            unsigned int power;     // power of the boundary with the next run
+        };
+
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        if (size < 2)
+        {
+            return;
+        }
+        const std::size_t minRun = timSortMinRun(size);
+
+        const auto nextRun = [&](T* begin) -> Run
+        {
+            std::size_t runSize = countRunAndMakeAscending(begin, last, comp);
+            if (runSize < minRun)
+            {
+                const std::size_t forced = std::min(minRun, static_cast<std::size_t>(last - begin));
+                insertionSort(begin, begin + forced, comp);
+                runSize = forced;
+            }
+            return Run{ begin, runSize, 0 };
+        };
+
+        // Powers on the stack grow strictly upwards, so it never holds more
+        // runs than there are bits in size
+        Run stack[sizeof(std::size_t) * 8 + 1];
+        std::size_t stackSize = 0;
+
+        Run current = nextRun(first);
+        while (current.begin + current.size < last)
+        {
+            const Run next = nextRun(current.begin + current.size);
+            const unsigned int power = powersortNodePower(size,
+                static_cast<std::size_t>(current.begin - first), current.size, next.size);
+            while (stackSize > 0 && stack[stackSize - 1].power > power)
+            {
+                const Run& left = stack[--stackSize];
+                mergeRuns(left.begin, current.begin, current.begin + current.size, buffer, comp);
+                current = Run{ left.begin, left.size + current.size, 0 };
+            }
+            current.power = power;
+            stack[stackSize++] = current;
+            current = next;
+        }
+        while (stackSize > 0)
+        {
+            const Run& left = stack[--stackSize];
+            mergeRuns(left.begin, current.begin, current.begin + current.size, buffer, comp);
+            current = Run{ left.begin, left.size + current.size, 0 };
+        }
+    }
+}
+
+///=============================================================================
+/// Adaptive stable sort ("TimSort" family, powersort merge policy). Unlike
+/// QuickSort, elements which compare equal keep their order, and the natural
+/// runs of the input are exploited: appending a few keys to a sorted array
+/// and sorting again costs close to O(n).
+///
+/// The scratch buffer (n / 2 elements) is kept by the object and reused by
+/// subsequent sorts.
+///
+/// Example of usage:
+/// std::vector<int> keys = loadKeys();
+/// TimSort<int> timSort(keys);
+/// timSort.sort();
+/// keys.push_back(42);
+/// TimSort<int>(keys).sort();                          // two runs, one merge
+/// timSort.sortBy(std::less<int>(), [](const int key) { return key / 100; }); // stable by bucket
+///=============================================================================
+template <typename T, size_t SIZE = DYNAMIC_SIZE>
+class TimSort : public SortingCore<T, SIZE>
+{
+public:
+    using SortingCore<T, SIZE>::SortingCore;
+
+    ///=============================================================================
+    ///=============================================================================
+    ~TimSort() {}
+
+    ///=============================================================================
+    /// @brief Sorts the array, dispatching once on the runtime order.
+    ///
+    /// @param const SortOrder order - sort order.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void sort(const SortOrder order = SortOrder::ASC)
+    {
+        if (order == SortOrder::ASC)
+        {
+            sort<SortOrder::ASC>();
+        }
+        else
+        {
+            sort<SortOrder::DESC>();
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array in the order known at compile time.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <SortOrder ORDER>
+    void sort()
+    {
+        sortBy(OrderedBefore<T, ORDER>());
+    }
+
+    ///=============================================================================
+    /// @brief Sorts the array by a user-supplied predicate over projected keys.
+    ///        Elements with equal keys keep their order.
+    ///
+    /// @param Compare comp - returns true if the first key must be placed before
+    ///                       the second one (like std::less).
+    /// @param Projection proj - maps an element onto the key to compare.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Compare, typename Projection = IdentityProjection>
+    void sortBy(Compare comp,
+                Projection proj = Projection())
+    {
+        const std::size_t size = this->size();
+        if (m_bufferSize < size / 2)
+        {
+            m_buffer.reset(new T[size / 2]);
+            m_bufferSize = size / 2;
+        }
+        SortingKernels::timSort(this->data(), this->data() + size,
+                                makeProjectedBefore(comp, proj), m_buffer.get());
+    }
+
+private:
+    // Scratch buffer, a plain array: std::vector<bool> would have no data()
+    std::unique_ptr<T[]> m_buffer;
+    std::size_t          m_bufferSize = 0;
+};
+
+#endif // TIMSORT_H
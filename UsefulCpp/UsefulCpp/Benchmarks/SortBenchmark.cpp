@@ -0,0 +1,91 @@
+///=============================================================================
+/// Entry point of the sort benchmark (see SortBenchmark.h). Build it as its own
+/// executable, with optimizations on.
+///
+/// Usage:
+/// SortBenchmark [--sizes 16,1000,1000000] [--min-time ms] [--threads n]
+///               [--csv results.csv] [--json results.json]
+///
+/// Results are printed to stdout as CSV while the benchmark runs and written
+/// to the given files when it is done.
+///=============================================================================
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "SortBenchmark.h"
+
+///=============================================================================
+/// @brief Parses a comma-separated list of sizes.
+///
+/// @param const std::string& text - list of sizes.
+///
+/// @return std::vector<std::size_t> - sizes.
+///=============================================================================
+static std::vector<std::size_t> parseSizes(const std::string& text)
+{
+    std::vector<std::size_t> sizes;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        sizes.push_back(static_cast<std::size_t>(std::stoull(item)));
+    }
+    return sizes;
+}
+
+int main(int argc, char* argv[])
+{
+    SortBenchmarkConfig config;
+    std::string csvPath;
+    std::string jsonPath;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--sizes")
+        {
+            config.sizes = parseSizes(value);
+        }
+        else if (option == "--min-time")
+        {
+            config.minTimeMs = std::stod(value);
+        }
+        else if (option == "--threads")
+        {
+            config.threadCount = static_cast<unsigned int>(std::stoul(value));
+        }
+        else if (option == "--csv")
+        {
+            csvPath = value;
+        }
+        else if (option == "--json")
+        {
+            jsonPath = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    SortBenchmark benchmark(config);
+    SortBenchmark::writeCsvHeader(std::cout);
+    benchmark.run(&std::cout);
+
+    if (!csvPath.empty())
+    {
+        std::ofstream csv(csvPath);
+        benchmark.writeCsv(csv);
+    }
+    if (!jsonPath.empty())
+    {
+        std::ofstream json(jsonPath);
+        benchmark.writeJson(json);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,541 @@
+#ifndef SORTBENCHMARK_H
+#define SORTBENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "..\Algorithms\BubbleSort\BubbleSort.h"
+#include "..\Algorithms\QuickSort\QuickSort.h"
+#include "..\Algorithms\RadixSort\RadixSort.h"
+#include "..\Algorithms\TimSort\TimSort.h"
+#include "..\Algorithms\Parallel\WorkStealingPool.h"
+#include "..\Algorithms\SortStatistics.h"
+
+///=============================================================================
+/// Benchmark of all sort engines over the standard input distributions,
+/// element widths from 8 to 64 bits and sizes from 16 to 10^8.
+///
+/// Every measurement reports nanoseconds per element (sort only, the copy of
+/// the input is not timed), comparisons per run (counted by a separate untimed
+/// pass through sortBy()) and swaps per run (only when the code is built with
+/// SORTING_COLLECT_STATISTICS, see SortStatistics.h). Missing figures are
+/// written as empty CSV fields and JSON nulls.
+///
+/// Example of usage:
+/// SortBenchmarkConfig config;
+/// config.sizes = { 16, 1000, 1000000 };
+/// SortBenchmark benchmark(config);
+/// benchmark.run();
+/// benchmark.writeCsv(std::cout);
+///=============================================================================
+
+///=============================================================================
+/// Shapes of the generated input.
+///=============================================================================
+enum class Distribution
+{
+    RANDOM,             // uniform over the whole range of the type
+    SORTED,             // already in ascending order
+    REVERSE_SORTED,     // in descending order
+    ORGAN_PIPE,         // ascending first half, descending second half
+    FEW_UNIQUE,         // 16 distinct values
+    ZIPF                // skewed frequencies, rank r appears ~1/r times
+};
+
+///=============================================================================
+/// One measured point. Counters are -1 when they are not available.
+///=============================================================================
+struct SortBenchmarkResult
+{
+    std::string   engine;
+    std::string   type;
+    Distribution  distribution;
+    std::size_t   size;
+    double        nsPerElement;
+    std::int64_t  comparisons;
+    std::int64_t  swaps;
+};
+
+///=============================================================================
+/// Parameters of a benchmark run.
+///=============================================================================
+struct SortBenchmarkConfig
+{
+    std::vector<std::size_t>  sizes{ 16, 256, 4096, 65536, 1000000, 10000000, 100000000 };
+    std::vector<Distribution> distributions{ Distribution::RANDOM,
+                                             Distribution::SORTED,
+                                             Distribution::REVERSE_SORTED,
+                                             Distribution::ORGAN_PIPE,
+                                             Distribution::FEW_UNIQUE,
+                                             Distribution::ZIPF };
+    double                    minTimeMs = 200.0;    // per point, repeated until reached
+    std::size_t               batchElements = 1 << 16; // small sizes are sorted in batches of this many elements
+    std::size_t               bubbleSortMaxSize = 4096; // O(n^2), larger sizes are skipped
+    std::size_t               countMaxSize = 1 << 24; // comparisons are not counted above
+    unsigned int              threadCount = 0;      // parallel engine, 0 - all cores
+    std::uint64_t             seed = 20240229;
+};
+
+///=============================================================================
+/// @brief Gets name of the distribution.
+///
+/// @param const Distribution distribution - distribution.
+///
+/// @return const char* - name.
+///=============================================================================
+inline const char* distributionName(const Distribution distribution)
+{
+    switch (distribution)
+    {
+    default:
+    case Distribution::RANDOM:         return "random";
+    case Distribution::SORTED:         return "sorted";
+    case Distribution::REVERSE_SORTED: return "reverse_sorted";
+    case Distribution::ORGAN_PIPE:     return "organ_pipe";
+    case Distribution::FEW_UNIQUE:     return "few_unique";
+    case Distribution::ZIPF:           return "zipf";
+    }
+}
+
+///=============================================================================
+/// @brief Generates benchmark input. The same seed gives the same input.
+///
+/// @param const Distribution distribution - shape of the input.
+/// @param const std::size_t size - number of elements.
+/// @param const std::uint64_t seed - seed of the generator.
+///
+/// @return std::vector<T> - generated elements.
+///=============================================================================
+template <typename T>
+std::vector<T> generateInput(const Distribution distribution,
+                             const std::size_t size,
+                             const std::uint64_t seed)
+{
+    // Bits of the generator are spread over the whole range of T, signed included
+    std::mt19937_64 generator(seed);
+    const auto randomValue = [&generator]() { return static_cast<T>(generator()); };
+
+    std::vector<T> input(size);
+    switch (distribution)
+    {
+    default:
+    case Distribution::RANDOM:
+    case Distribution::SORTED:
+    case Distribution::REVERSE_SORTED:
+    case Distribution::ORGAN_PIPE:
+        std::generate(input.begin(), input.end(), randomValue);
+        break;
+    case Distribution::FEW_UNIQUE:
+    {
+        T values[16];
+        std::generate(std::begin(values), std::end(values), randomValue);
+        for (T& element : input)
+        {
+            element = values[generator() % 16];
+        }
+        break;
+    }
+    case Distribution::ZIPF:
+    {
+        // Inverse CDF over up to 64K ranks, each rank mapped to a random value
+        const std::size_t ranks = std::max<std::size_t>(1, std::min<std::size_t>(size, 1 << 16));
+        std::vector<double> cdf(ranks);
+        std::vector<T> values(ranks);
+        double total = 0.0;
+        for (std::size_t rank = 0; rank < ranks; ++rank)
+        {
+            total += 1.0 / static_cast<double>(rank + 1);
+            cdf[rank] = total;
+            values[rank] = randomValue();
+        }
+        std::uniform_real_distribution<double> uniform(0.0, total);
+        for (T& element : input)
+        {
+            const auto rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(generator)) - cdf.begin();
+            element = values[std::min<std::size_t>(static_cast<std::size_t>(rank), ranks - 1)];
+        }
+        break;
+    }
+    }
+
+    // Ordered shapes are made of random values, so they work for every width
+    switch (distribution)
+    {
+    case Distribution::SORTED:
+        std::sort(input.begin(), input.end());
+        break;
+    case Distribution::REVERSE_SORTED:
+        std::sort(input.begin(), input.end(), [](const T lhs, const T rhs) { return rhs < lhs; });
+        break;
+    case Distribution::ORGAN_PIPE:
+    {
+        // Even ranks rise to the peak, odd ranks fall back from it
+        std::sort(input.begin(), input.end());
+        std::vector<T> pipe(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            pipe[i % 2 == 0 ? i / 2 : size - 1 - i / 2] = input[i];
+        }
+        input.swap(pipe);
+        break;
+    }
+    default:
+        break;
+    }
+    return input;
+}
+
+///=============================================================================
+/// Runs every engine over every configured type, distribution and size.
+///=============================================================================
+class SortBenchmark
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const SortBenchmarkConfig& config - benchmark parameters.
+    ///=============================================================================
+    explicit SortBenchmark(const SortBenchmarkConfig& config = SortBenchmarkConfig())
+        : m_config(config)
+        , m_pool(config.threadCount == 0 ? WorkStealingPool::defaultWorkerCount() : config.threadCount - 1)
+    {}
+
+    ///=============================================================================
+    /// @brief Runs the benchmark over int8 ... int64 keys.
+    ///
+    /// @param std::ostream* progress - receives a line per point, if not null.
+    ///
+    /// @return const std::vector<SortBenchmarkResult>& - all results so far.
+    ///=============================================================================
+    const std::vector<SortBenchmarkResult>& run(std::ostream* progress = nullptr)
+    {
+        runType<std::int8_t>("int8", progress);
+        runType<std::int16_t>("int16", progress);
+        runType<std::int32_t>("int32", progress);
+        runType<std::int64_t>("int64", progress);
+        return m_results;
+    }
+
+    ///=============================================================================
+    /// @brief Runs the benchmark over a single key type.
+    ///
+    /// @param const std::string& typeName - name of the type in the report.
+    /// @param std::ostream* progress - receives a line per point, if not null.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T>
+    void runType(const std::string& typeName,
+                 std::ostream* progress = nullptr)
+    {
+        const std::vector<Engine<T>> engines = makeEngines<T>();
+        for (const Distribution distribution : m_config.distributions)
+        {
+            for (const std::size_t size : m_config.sizes)
+            {
+                const std::vector<T> input = generateInput<T>(distribution, size, m_config.seed + size);
+                for (const Engine<T>& engine : engines)
+                {
+                    if (size > engine.maxSize)
+                    {
+                        continue;
+                    }
+                    SortBenchmarkResult result{ engine.name, typeName, distribution, size, 0.0, -1, -1 };
+                    measure(engine, input, result);
+                    m_results.push_back(result);
+                    if (progress != nullptr)
+                    {
+                        writeCsvRow(*progress, result);
+                    }
+                }
+            }
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Gets all results so far.
+    ///=============================================================================
+    const std::vector<SortBenchmarkResult>& results() const noexcept { return m_results; }
+
+    ///=============================================================================
+    /// @brief Writes the results as CSV with a header row.
+    ///
+    /// @param std::ostream& stream - destination.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void writeCsv(std::ostream& stream) const
+    {
+        writeCsvHeader(stream);
+        for (const SortBenchmarkResult& result : m_results)
+        {
+            writeCsvRow(stream, result);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Writes the results as a JSON array of objects.
+    ///
+    /// @param std::ostream& stream - destination.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void writeJson(std::ostream& stream) const
+    {
+        stream << "[\n";
+        for (std::size_t i = 0; i < m_results.size(); ++i)
+        {
+            const SortBenchmarkResult& result = m_results[i];
+            stream << "  {\"engine\": \"" << result.engine << "\""
+                   << ", \"type\": \"" << result.type << "\""
+                   << ", \"distribution\": \"" << distributionName(result.distribution) << "\""
+                   << ", \"size\": " << result.size
+                   << ", \"ns_per_element\": " << result.nsPerElement
+                   << ", \"comparisons\": ";
+            writeCounter(stream, result.comparisons, "null");
+            stream << ", \"swaps\": ";
+            writeCounter(stream, result.swaps, "null");
+            stream << (i + 1 < m_results.size() ? "},\n" : "}\n");
+        }
+        stream << "]\n";
+    }
+
+    ///=============================================================================
+    /// @brief Writes the CSV header row.
+    ///
+    /// @param std::ostream& stream - destination.
+    ///
+    /// @return void.
+    ///=============================================================================
+    static void writeCsvHeader(std::ostream& stream)
+    {
+        stream << "engine,type,distribution,size,ns_per_element,comparisons,swaps\n";
+    }
+
+    ///=============================================================================
+    /// @brief Writes a single result as a CSV row.
+    ///
+    /// @param std::ostream& stream - destination.
+    /// @param const SortBenchmarkResult& result - result to write.
+    ///
+    /// @return void.
+    ///=============================================================================
+    static void writeCsvRow(std::ostream& stream,
+                            const SortBenchmarkResult& result)
+    {
+        stream << result.engine << ','
+               << result.type << ','
+               << distributionName(result.distribution) << ','
+               << result.size << ','
+               << result.nsPerElement << ',';
+        writeCounter(stream, result.comparisons, "");
+        stream << ',';
+        writeCounter(stream, result.swaps, "");
+        stream << '\n';
+    }
+
+private:
+    ///=============================================================================
+    /// Sort engine under test. sort() sorts [first, first + size) ascending,
+    /// count() does the same with a comparator that counts its calls and is left
+    /// empty for engines that cannot take one.
+    ///=============================================================================
+    template <typename T>
+    struct Engine
+    {
+        std::string                                                   name;
+        std::size_t                                                   maxSize;
+        bool                                                          countsSwaps;
+        std::function<void(T*, std::size_t)>                          sort;
+        std::function<void(T*, std::size_t, std::uint64_t&)>          count;
+    };
+
+    ///=============================================================================
+    /// Ascending predicate that counts its calls.
+    ///=============================================================================
+    template <typename T>
+    struct CountingLess
+    {
+        std::uint64_t* counter;
+
+        bool operator()(const T lhs,
+                        const T rhs) const
+        {
+            ++*counter;
+            return lhs < rhs;
+        }
+    };
+
+    ///=============================================================================
+    /// @brief Creates the engines under test.
+    ///
+    /// @return std::vector<Engine<T>> - engines.
+    ///=============================================================================
+    template <typename T>
+    std::vector<Engine<T>> makeEngines()
+    {
+        const std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+        std::vector<Engine<T>> engines;
+
+        engines.push_back({ "std::sort", unlimited, false,
+            [](T* data, std::size_t size) { std::sort(data, data + size); },
+            [](T* data, std::size_t size, std::uint64_t& counter)
+            {
+                std::sort(data, data + size, CountingLess<T>{ &counter });
+            } });
+
+        engines.push_back({ "BubbleSort", m_config.bubbleSortMaxSize, true,
+            [](T* data, std::size_t size) { BubbleSort<T>(data, size).sort(); },
+            [](T* data, std::size_t size, std::uint64_t& counter)
+            {
+                BubbleSort<T>(data, size).sortBy(CountingLess<T>{ &counter });
+            } });
+
+        const std::pair<const char*, PartitionScheme> schemes[] = {
+            { "QuickSort/hoare", PartitionScheme::HOARE },
+            { "QuickSort/block", PartitionScheme::BLOCK },
+            { "QuickSort/three_way", PartitionScheme::THREE_WAY } };
+        for (const auto& scheme : schemes)
+        {
+            const PartitionScheme partitionScheme = scheme.second;
+            engines.push_back({ scheme.first, unlimited, true,
+                [partitionScheme](T* data, std::size_t size)
+                {
+                    QuickSort<T> qSort(data, size);
+                    qSort.setPartitionScheme(partitionScheme);
+                    qSort.sort();
+                },
+                [partitionScheme](T* data, std::size_t size, std::uint64_t& counter)
+                {
+                    QuickSort<T> qSort(data, size);
+                    qSort.setPartitionScheme(partitionScheme);
+                    qSort.sortBy(CountingLess<T>{ &counter });
+                } });
+        }
+
+        // Counters are per thread, so the parallel engine reports time only
+        WorkStealingPool* pool = &m_pool;
+        engines.push_back({ "QuickSort/parallel", unlimited, false,
+            [pool](T* data, std::size_t size)
+            {
+                QuickSort<T> qSort(data, size);
+                qSort.setPartitionScheme(PartitionScheme::BLOCK);
+                qSort.parallelSort(*pool);
+            },
+            nullptr });
+
+        // Stable merges move elements through the scratch buffer, there are no swaps
+        engines.push_back({ "TimSort", unlimited, false,
+            [](T* data, std::size_t size) { TimSort<T>(data, size).sort(); },
+            [](T* data, std::size_t size, std::uint64_t& counter)
+            {
+                TimSort<T>(data, size).sortBy(CountingLess<T>{ &counter });
+            } });
+
+        // No comparisons and no swaps, elements are scattered between two buffers
+        engines.push_back({ "RadixSort", unlimited, false,
+            [](T* data, std::size_t size) { RadixSort<T>(data, size).sort(); },
+            [](T* data, std::size_t size, std::uint64_t&) { RadixSort<T>(data, size).sort(); } });
+
+        return engines;
+    }
+
+    ///=============================================================================
+    /// @brief Measures an engine over the input. Inputs shorter than
+    ///        batchElements are replicated and sorted as a batch of independent
+    ///        copies, so that a single timing covers enough work.
+    ///
+    /// @param const Engine<T>& engine - engine under test.
+    /// @param const std::vector<T>& input - unsorted input.
+    /// @param SortBenchmarkResult& result - receives the figures.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T>
+    void measure(const Engine<T>& engine,
+                 const std::vector<T>& input,
+                 SortBenchmarkResult& result) const
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const std::size_t size = input.size();
+        if (size == 0)
+        {
+            return;
+        }
+        const std::size_t copies = std::max<std::size_t>(1, m_config.batchElements / size);
+        std::vector<T> batch(size * copies);
+        for (std::size_t copy = 0; copy < copies; ++copy)
+        {
+            std::copy(input.begin(), input.end(), batch.begin() + static_cast<std::ptrdiff_t>(copy * size));
+        }
+        std::vector<T> work(batch.size());
+
+        double totalNs = 0.0;
+        std::size_t sortedElements = 0;
+        do
+        {
+            std::copy(batch.begin(), batch.end(), work.begin());
+            const Clock::time_point start = Clock::now();
+            for (std::size_t copy = 0; copy < copies; ++copy)
+            {
+                engine.sort(work.data() + copy * size, size);
+            }
+            totalNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            sortedElements += work.size();
+        } while (totalNs < m_config.minTimeMs * 1e6);
+        result.nsPerElement = totalNs / static_cast<double>(sortedElements);
+
+        // Operation counts of a single run, outside of the timed loop
+        if (engine.count && size <= m_config.countMaxSize)
+        {
+            std::copy(input.begin(), input.end(), work.begin());
+            std::uint64_t comparisons = 0;
+            SortingKernels::statistics() = SortStatistics();
+            engine.count(work.data(), size, comparisons);
+            result.comparisons = static_cast<std::int64_t>(comparisons);
+#if defined(SORTING_COLLECT_STATISTICS)
+            if (engine.countsSwaps)
+            {
+                result.swaps = static_cast<std::int64_t>(SortingKernels::statistics().swaps);
+            }
+#endif
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Writes a counter, or the placeholder if it is not available.
+    ///
+    /// @return void.
+    ///=============================================================================
+    static void writeCounter(std::ostream& stream,
+                             const std::int64_t counter,
+                             const char* missing)
+    {
+        if (counter < 0)
+        {
+            stream << missing;
+        }
+        else
+        {
+            stream << counter;
+        }
+    }
+
+    SortBenchmarkConfig              m_config;
+    WorkStealingPool                 m_pool;
+    std::vector<SortBenchmarkResult> m_results;
+};
+
+#endif // SORTBENCHMARK_H
@@ -0,0 +1,67 @@
+///=============================================================================
+/// Entry point of the String benchmark (see StringBenchmark.h). Build it as
+/// its own executable, with optimizations on.
+///
+/// Usage:
+/// StringBenchmark [--size characters] [--min-time ms]
+///                 [--csv results.csv] [--json results.json]
+///
+/// Results are printed to stdout as CSV while the benchmark runs and written
+/// to the given files when it is done.
+///=============================================================================
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "StringBenchmark.h"
+
+int main(int argc, char* argv[])
+{
+    StringBenchmarkConfig config;
+    std::string csvPath;
+    std::string jsonPath;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--size")
+        {
+            config.buildSize = static_cast<std::size_t>(std::stoull(value));
+        }
+        else if (option == "--min-time")
+        {
+            config.minTimeMs = std::stod(value);
+        }
+        else if (option == "--csv")
+        {
+            csvPath = value;
+        }
+        else if (option == "--json")
+        {
+            jsonPath = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    StringBenchmark benchmark(config);
+    StringBenchmark::writeCsvHeader(std::cout);
+    benchmark.run(&std::cout);
+
+    if (!csvPath.empty())
+    {
+        std::ofstream csv(csvPath);
+        benchmark.writeCsv(csv);
+    }
+    if (!jsonPath.empty())
+    {
+        std::ofstream json(jsonPath);
+        benchmark.writeJson(json);
+    }
+    return EXIT_SUCCESS;
+}
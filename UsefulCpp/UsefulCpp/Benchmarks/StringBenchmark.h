@@ -0,0 +1,449 @@
+#ifndef STRINGBENCHMARK_H
+#define STRINGBENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "..\Patterns\String\String.h"
+#include "..\Patterns\String\StringFormat.h"
+#include "..\Patterns\String\StringTranscode.h"
+
+///=============================================================================
+/// Benchmark of the String operations. Every case processes a known number of
+/// bytes per run and is repeated until minTimeMs is reached; the report gives
+/// nanoseconds per byte and GB/s.
+///
+/// Example of usage:
+/// StringBenchmark benchmark;
+/// benchmark.run(&std::cout);
+/// benchmark.writeCsv(csvFile);
+///=============================================================================
+
+///=============================================================================
+/// One measured case.
+///=============================================================================
+struct StringBenchmarkResult
+{
+    std::string benchmark;
+    std::size_t bytes;          // processed by a single run
+    double      nsPerByte;
+    double      gbPerSecond;
+};
+
+///=============================================================================
+/// Parameters of a benchmark run.
+///=============================================================================
+struct StringBenchmarkConfig
+{
+    std::size_t buildSize = 1 << 20;    // characters of the strings built by appends
+    double      minTimeMs = 200.0;      // per case, repeated until reached
+};
+
+///=============================================================================
+/// Runs the String cases.
+///=============================================================================
+class StringBenchmark
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const StringBenchmarkConfig& config - benchmark parameters.
+    ///=============================================================================
+    explicit StringBenchmark(const StringBenchmarkConfig& config = StringBenchmarkConfig())
+        : m_config(config)
+        , m_sink(0)
+    {}
+
+    ///=============================================================================
+    /// @brief Runs all the cases.
+    ///
+    /// @param std::ostream* progress - receives a CSV row per case, if not null.
+    ///
+    /// @return const std::vector<StringBenchmarkResult>& - all results so far.
+    ///=============================================================================
+    const std::vector<StringBenchmarkResult>& run(std::ostream* progress = nullptr)
+    {
+        runAppendCases(progress);
+        runHashCases(progress);
+        runTranscodeCases(progress);
+        runFormatCases(progress);
+        return m_results;
+    }
+
+    ///=============================================================================
+    /// @brief Building a string of buildSize characters by appends, one
+    ///        character (or one small chunk) at a time.
+    ///
+    /// @param std::ostream* progress - receives a CSV row per case, if not null.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void runAppendCases(std::ostream* progress = nullptr)
+    {
+        const std::size_t size = m_config.buildSize;
+        const char chunk[] = "0123456789abcdef";
+
+        measure("CString::push_back", size, progress, [this, size]
+        {
+            CString str;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                str.push_back(static_cast<char>('a' + (i & 15)));
+            }
+            m_sink += str.size();
+        });
+        measure("CString::operator+=(char)", size, progress, [this, size]
+        {
+            CString str;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                str += static_cast<char>('a' + (i & 15));
+            }
+            m_sink += str.size();
+        });
+        measure("CString::reserve+push_back", size, progress, [this, size]
+        {
+            CString str;
+            str.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                str.push_back(static_cast<char>('a' + (i & 15)));
+            }
+            m_sink += str.size();
+        });
+        measure("CString::append(ptr,16)", size, progress, [this, size, &chunk]
+        {
+            CString str;
+            for (std::size_t i = 0; i < size; i += 16)
+            {
+                str.append(chunk, 16);
+            }
+            m_sink += str.size();
+        });
+        measure("WString::push_back", size * sizeof(wchar_t), progress, [this, size]
+        {
+            WString str;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                str.push_back(static_cast<wchar_t>(L'a' + (i & 15)));
+            }
+            m_sink += str.size();
+        });
+        measure("std::string::push_back", size, progress, [this, size]
+        {
+            std::string str;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                str.push_back(static_cast<char>('a' + (i & 15)));
+            }
+            m_sink += str.size();
+        });
+    }
+
+    ///=============================================================================
+    /// @brief Hashing keys of a few sizes and a buildSize string, against
+    ///        std::hash of std::string_view.
+    ///
+    /// @param std::ostream* progress - receives a CSV row per case, if not null.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void runHashCases(std::ostream* progress = nullptr)
+    {
+        CString text(m_config.buildSize);
+        for (std::size_t i = 0; i < m_config.buildSize; ++i)
+        {
+            text.push_back(static_cast<char>('a' + (i * 7) % 26));
+        }
+
+        const std::size_t keySizes[] = { 8, 32, 200, 4096 };
+        for (const std::size_t keySize : keySizes)
+        {
+            if (keySize > text.size())
+            {
+                continue;
+            }
+            // Hashes every key of keySize characters at consecutive offsets
+            const std::size_t keys = (text.size() - keySize) / 8 + 1;
+            const std::string suffix = "(" + std::to_string(keySize) + ")";
+            measure("std::hash<CStringView>" + suffix, keys * keySize, progress, [this, &text, keySize, keys]
+            {
+                std::size_t sum = 0;
+                for (std::size_t k = 0; k < keys; ++k)
+                {
+                    sum += std::hash<CStringView>()(CStringView(text.begin() + 8 * k, keySize));
+                }
+                m_sink += sum;
+            });
+            measure("std::hash<std::string_view>" + suffix, keys * keySize, progress, [this, &text, keySize, keys]
+            {
+                std::size_t sum = 0;
+                for (std::size_t k = 0; k < keys; ++k)
+                {
+                    sum += std::hash<std::string_view>()(std::string_view(text.begin() + 8 * k, keySize));
+                }
+                m_sink += sum;
+            });
+        }
+        measure("std::hash<CString>(buildSize)", text.size(), progress, [this, &text]
+        {
+            m_sink += std::hash<CString>()(text);
+        });
+    }
+
+    ///=============================================================================
+    /// @brief Transcoding buildSize bytes of UTF-8 to WString and back, for
+    ///        ASCII and for mixed text, with the vector kernels and with the
+    ///        portable ones. Throughput is per UTF-8 byte.
+    ///
+    /// @param std::ostream* progress - receives a CSV row per case, if not null.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void runTranscodeCases(std::ostream* progress = nullptr)
+    {
+        // ASCII words, and the same with a 2-byte and a 3-byte character in every line
+        const char* const samples[2][2] =
+        {
+            { "ascii", "The quick brown fox jumps over the lazy dog 0123456789\n" },
+            { "mixed", "The quick brown fox \xC3\xA9 jumps over the lazy \xE2\x82\xAC dog\n" }
+        };
+        for (const auto& sample : samples)
+        {
+            CString utf8;
+            while (utf8.size() < m_config.buildSize)
+            {
+                utf8.append(sample[1]);
+            }
+            const WString wide = toWString(utf8);
+            const std::string suffix = std::string("(") + sample[0] + ")";
+
+            WString wideOut;
+            CString utf8Out;
+            measure("transcode(utf8->WString)" + suffix, utf8.size(), progress, [this, &utf8, &wideOut]
+            {
+                transcode(utf8, wideOut);
+                m_sink += wideOut.size();
+            });
+            measure("transcode(WString->utf8)" + suffix, utf8.size(), progress, [this, &wide, &utf8Out]
+            {
+                transcode(wide, utf8Out);
+                m_sink += utf8Out.size();
+            });
+            std::vector<wchar_t> buffer(utf8.size());
+            measure("utf8ToWideKernel<ScalarAscii>" + suffix, utf8.size(), progress, [this, &utf8, &buffer]
+            {
+                m_sink += StringKernels::utf8ToWideKernel<StringKernels::ScalarAscii>(utf8.begin(), utf8.size(), buffer.data()).written;
+            });
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Serializing buildSize / 8 random 32 and 64-bit keys as text and
+    ///        parsing them back, against std::ostringstream. Throughput is per
+    ///        byte of text.
+    ///
+    /// @param std::ostream* progress - receives a CSV row per case, if not null.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void runFormatCases(std::ostream* progress = nullptr)
+    {
+        const std::size_t count = m_config.buildSize / 8;
+        std::mt19937_64 random(42);
+        std::vector<std::uint32_t> keys32(count);
+        std::vector<std::uint64_t> keys64(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            keys64[i] = random();
+            keys32[i] = static_cast<std::uint32_t>(keys64[i]);
+        }
+
+        CString text32;
+        CString text64;
+        appendNumbers(keys32.data(), count, text32);
+        appendNumbers(keys64.data(), count, text64);
+
+        CString out;
+        measure("appendNumbers(uint32)", text32.size(), progress, [this, &keys32, &out, count]
+        {
+            out.clear();
+            appendNumbers(keys32.data(), count, out);
+            m_sink += out.size();
+        });
+        measure("appendNumbers(uint64)", text64.size(), progress, [this, &keys64, &out, count]
+        {
+            out.clear();
+            appendNumbers(keys64.data(), count, out);
+            m_sink += out.size();
+        });
+        std::vector<double> values(count);
+        CString textDouble;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            values[i] = static_cast<double>(keys64[i] >> 11) / 1024.0;
+            appendNumber(textDouble, values[i]).push_back(' ');
+        }
+        measure("appendNumber(double)", textDouble.size(), progress, [this, &values, &out]
+        {
+            out.clear();
+            for (const double value : values)
+            {
+                appendNumber(out, value).push_back(' ');
+            }
+            m_sink += out.size();
+        });
+        measure("std::ostringstream<<uint32", text32.size(), progress, [this, &keys32]
+        {
+            std::ostringstream stream;
+            for (const std::uint32_t key : keys32)
+            {
+                stream << key << ' ';
+            }
+            m_sink += stream.str().size();
+        });
+        measure("parseNumber(uint32)", text32.size(), progress, [this, &text32]
+        {
+            std::uint64_t sum = 0;
+            for (const CStringView token : text32.split(' '))
+            {
+                sum += parseNumber<std::uint32_t>(token);
+            }
+            m_sink += static_cast<std::size_t>(sum);
+        });
+        measure("std::istringstream>>uint32", text32.size(), progress, [this, &text32]
+        {
+            std::istringstream stream(text32.c_str());
+            std::uint64_t sum = 0;
+            std::uint32_t key = 0;
+            while (stream >> key)
+            {
+                sum += key;
+            }
+            m_sink += static_cast<std::size_t>(sum);
+        });
+    }
+
+    ///=============================================================================
+    /// @brief Measures a case and records the result.
+    ///
+    /// @param const std::string& name - name of the case.
+    /// @param const std::size_t bytes - bytes processed by a single run.
+    /// @param std::ostream* progress - receives a CSV row, if not null.
+    /// @param const std::function<void()>& body - single run of the case.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void measure(const std::string& name,
+                 const std::size_t bytes,
+                 std::ostream* progress,
+                 const std::function<void()>& body)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        body(); // warm-up
+        double totalNs = 0.0;
+        std::size_t runs = 0;
+        do
+        {
+            const Clock::time_point start = Clock::now();
+            body();
+            totalNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            ++runs;
+        } while (totalNs < m_config.minTimeMs * 1e6);
+
+        const double nsPerByte = totalNs / (static_cast<double>(bytes) * static_cast<double>(runs));
+        m_results.push_back({ name, bytes, nsPerByte, 1.0 / nsPerByte });
+        if (progress != nullptr)
+        {
+            writeCsvRow(*progress, m_results.back());
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Gets all results so far.
+    ///=============================================================================
+    const std::vector<StringBenchmarkResult>& results() const noexcept { return m_results; }
+
+    ///=============================================================================
+    /// @brief Writes the results as CSV with a header row.
+    ///
+    /// @param std::ostream& stream - destination.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void writeCsv(std::ostream& stream) const
+    {
+        writeCsvHeader(stream);
+        for (const StringBenchmarkResult& result : m_results)
+        {
+            writeCsvRow(stream, result);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Writes the results as a JSON array of objects.
+    ///
+    /// @param std::ostream& stream - destination.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void writeJson(std::ostream& stream) const
+    {
+        stream << "[\n";
+        for (std::size_t i = 0; i < m_results.size(); ++i)
+        {
+            const StringBenchmarkResult& result = m_results[i];
+            stream << "  {\"benchmark\": \"" << result.benchmark << "\""
+                   << ", \"bytes\": " << result.bytes
+                   << ", \"ns_per_byte\": " << result.nsPerByte
+                   << ", \"gb_per_s\": " << result.gbPerSecond
+                   << (i + 1 < m_results.size() ? "},\n" : "}\n");
+        }
+        stream << "]\n";
+    }
+
+    ///=============================================================================
+    /// @brief Writes the CSV header row.
+    ///
+    /// @param std::ostream& stream - destination.
+    ///
+    /// @return void.
+    ///=============================================================================
+    static void writeCsvHeader(std::ostream& stream)
+    {
+        stream << "benchmark,bytes,ns_per_byte,gb_per_s\n";
+    }
+
+    ///=============================================================================
+    /// @brief Writes a single result as a CSV row.
+    ///
+    /// @param std::ostream& stream - destination.
+    /// @param const StringBenchmarkResult& result - result to write.
+    ///
+    /// @return void.
+    ///=============================================================================
+    static void writeCsvRow(std::ostream& stream,
+                            const StringBenchmarkResult& result)
+    {
+        stream << result.benchmark << ','
+               << result.bytes << ','
+               << result.nsPerByte << ','
+               << result.gbPerSecond << '\n';
+    }
+
+private:
+    StringBenchmarkConfig              m_config;
+    std::size_t                        m_sink;     // keeps the results alive for the optimizer
+    std::vector<StringBenchmarkResult> m_results;
+};
+
+#endif // STRINGBENCHMARK_H
@@ -0,0 +1,272 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "File.h"
+#include "MappedOutputFile.h"
+#include "..\Patterns\String\StringFormat.h"
+
+///=============================================================================
+/// Buffered output for bulk text: text and numbers are appended to a large
+/// buffer (a CString, reused for the whole life of the writer), which goes to
+/// the target in one OS call when it is full, on flush() and on close().
+/// Numbers are formatted right into the buffer (see StringFormat.h), with no
+/// stream, locale nor flush per element.
+///
+/// The targets are the standard output, a file written with write(2), and a
+/// file written through a memory mapping (see MappedOutputFile.h). A block
+/// of at least half the buffer is not copied: the buffered bytes and the
+/// block go out in a single gathering call (writev).
+///
+/// The destructor flushes and ignores errors: call flush() or close() to get
+/// them as std::system_error.
+///
+/// Example of usage:
+/// BufferedWriter out("sorted.txt");
+/// out.writeNumbers(keys.data(), keys.size(), '\n');
+/// out.write('\n');
+/// out.close();
+///=============================================================================
+class BufferedWriter
+{
+public:
+    enum class Target
+    {
+        FILE,   // write(2) per buffer
+        MAPPED  // copied into a memory mapping of the file
+    };
+
+    // Capacity of the buffer
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = std::size_t(1) << 20;
+
+    // Smallest capacity, so that a chunk of formatted numbers always fits
+    static constexpr std::size_t MIN_BUFFER_SIZE = std::size_t(64) << 10;
+
+    ///=============================================================================
+    /// @brief Constructor. Writes to the standard output.
+    ///
+    /// @param const std::size_t bufferSize - capacity of the buffer.
+    ///=============================================================================
+    explicit BufferedWriter(const std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+        : m_file(File::standardOutput())
+        , m_capacity(bufferSize < MIN_BUFFER_SIZE ? MIN_BUFFER_SIZE : bufferSize)
+    {
+        m_buffer.reserve(m_capacity);
+    }
+
+    ///=============================================================================
+    /// @brief Constructor. Creates or truncates a file.
+    ///
+    /// @param const std::string& path - path to the file.
+    /// @param const Target target - how the file is written.
+    /// @param const std::size_t bufferSize - capacity of the buffer.
+    ///=============================================================================
+    explicit BufferedWriter(const std::string& path,
+                            const Target target = Target::FILE,
+                            const std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+        : m_capacity(bufferSize < MIN_BUFFER_SIZE ? MIN_BUFFER_SIZE : bufferSize)
+    {
+        if (target == Target::MAPPED)
+        {
+            m_mapped.reset(new MappedOutputFile(path));
+        }
+        else
+        {
+            m_file = File(path, File::Mode::WRITE);
+        }
+        m_buffer.reserve(m_capacity);
+    }
+
+    // Forbids copying
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    ///=============================================================================
+    /// @brief Destructor. Flushes and closes the target, ignoring errors.
+    ///=============================================================================
+    ~BufferedWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Writes bytes bytes.
+    ///
+    /// @param const void* data - source.
+    /// @param const std::size_t bytes - number of bytes.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void write(const void* data,
+               const std::size_t bytes)
+    {
+        if (m_buffer.size() + bytes <= m_capacity)
+        {
+            m_buffer.append(static_cast<const char*>(data), bytes);
+            return;
+        }
+        if (bytes >= m_capacity / 2)
+        {
+            // Large block: no copy, out together with the buffered bytes
+            writeTarget(m_buffer.data(), m_buffer.size(), data, bytes);
+            m_buffer.clear();
+            return;
+        }
+        flush();
+        m_buffer.append(static_cast<const char*>(data), bytes);
+    }
+
+    ///=============================================================================
+    /// @brief Writes characters.
+    ///=============================================================================
+    void write(const BasicStringView<char> text)
+    {
+        write(text.data(), text.size());
+    }
+
+    ///=============================================================================
+    /// @brief Writes a single character.
+    ///=============================================================================
+    void write(const char c)
+    {
+        if (m_buffer.size() == m_capacity)
+        {
+            flush();
+        }
+        m_buffer.push_back(c);
+    }
+
+    ///=============================================================================
+    /// @brief Writes a number in decimal (shortest round-trip form for the
+    ///        floating-point types).
+    ///
+    /// @param const T value - number.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename T,
+              typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    void writeNumber(const T value)
+    {
+        makeRoom(StringKernels::MAX_FLOAT_CHARS);
+        appendNumber(m_buffer, value);
+    }
+
+    ///=============================================================================
+    /// @brief Writes count integers, with separator between them.
+    ///
+    /// @param const Int* values - integers.
+    /// @param const std::size_t count - number of integers.
+    /// @param const char separator - character between two values.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Int,
+              typename = typename std::enable_if<std::is_integral<Int>::value>::type>
+    void writeNumbers(const Int* values,
+                      const std::size_t count,
+                      const char separator = ' ')
+    {
+        const std::size_t CHUNK = 1024;
+        for (std::size_t first = 0; first < count; first += CHUNK)
+        {
+            const std::size_t chunk = count - first < CHUNK ? count - first : CHUNK;
+            makeRoom(chunk * (StringKernels::MAX_INTEGER_CHARS + 1) + 1);
+            if (first != 0)
+            {
+                m_buffer.push_back(separator);
+            }
+            appendNumbers(values + first, chunk, m_buffer, separator);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sends the buffered bytes to the target.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void flush()
+    {
+        if (!m_buffer.empty())
+        {
+            writeTarget(m_buffer.data(), m_buffer.size(), nullptr, 0);
+            m_buffer.clear();
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Flushes and closes the target (the standard output stays open).
+    ///        Nothing may be written afterwards.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void close()
+    {
+        if (m_mapped != nullptr || m_file.isOpen())
+        {
+            flush();
+        }
+        if (m_mapped != nullptr)
+        {
+            m_mapped->close();
+        }
+        m_file.close();
+    }
+
+    ///=============================================================================
+    /// @brief Gets the number of buffered bytes, not sent to the target yet.
+    ///=============================================================================
+    std::size_t buffered() const noexcept { return m_buffer.size(); }
+
+private:
+    ///=============================================================================
+    /// @brief Flushes unless bytes more fit the capacity.
+    ///=============================================================================
+    void makeRoom(const std::size_t bytes)
+    {
+        if (m_buffer.size() + bytes > m_capacity)
+        {
+            flush();
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Sends firstBytes of first, then secondBytes of second, to the target.
+    ///=============================================================================
+    void writeTarget(const void* first,
+                     const std::size_t firstBytes,
+                     const void* second,
+                     const std::size_t secondBytes)
+    {
+        if (m_mapped != nullptr)
+        {
+            m_mapped->write(first, firstBytes);
+            m_mapped->write(second, secondBytes);
+        }
+        else if (secondBytes == 0)
+        {
+            m_file.write(first, firstBytes);
+        }
+        else
+        {
+            m_file.write(first, firstBytes, second, secondBytes);
+        }
+    }
+
+    File                              m_file;
+    std::unique_ptr<MappedOutputFile> m_mapped;
+    CString                           m_buffer;
+    std::size_t                       m_capacity;
+};
+
+#endif // BUFFEREDWRITER_H
@@ -0,0 +1,479 @@
+#ifndef FILE_H
+#define FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+///=============================================================================
+/// Thin RAII wrapper over a native file handle (HANDLE on Windows, file
+/// descriptor elsewhere) with unbuffered read() and write(): every call goes
+/// straight to the OS, so callers are expected to pass large blocks.
+///
+/// Direct I/O (O_DIRECT, bypasses the page cache) can be requested for writing
+/// where the platform supports it. Then buffers, offsets and sizes must be
+/// multiples of DIRECT_IO_ALIGNMENT until disableDirectIo() is called.
+///
+/// Errors are reported with std::system_error.
+///=============================================================================
+class File
+{
+public:
+    enum class Mode
+    {
+        READ,       // existing file, read only
+        WRITE,      // created or truncated, write only
+        READ_WRITE  // created or truncated, read and write (for writable mappings)
+    };
+
+    // Alignment of buffers, offsets and sizes in the direct I/O mode
+    static constexpr std::size_t DIRECT_IO_ALIGNMENT = 4096;
+
+    ///=============================================================================
+    /// @brief Default constructor. Creates a closed file.
+    ///=============================================================================
+    File() noexcept
+        : m_handle(invalidHandle())
+        , m_direct(false)
+        , m_owned(true)
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Opens the file.
+    ///
+    /// @param const std::string& path - path to the file.
+    /// @param const Mode mode - open mode.
+    /// @param const bool directIo - bypass the page cache on writes, if supported.
+    ///=============================================================================
+    File(const std::string& path,
+         const Mode mode,
+         const bool directIo = false)
+        : File()
+    {
+#if defined(_WIN32)
+        (void)directIo;
+        m_handle = ::CreateFileA(path.c_str(),
+                                 mode == Mode::READ ? GENERIC_READ
+                                 : mode == Mode::WRITE ? GENERIC_WRITE
+                                 : GENERIC_READ | GENERIC_WRITE,
+                                 FILE_SHARE_READ,
+                                 nullptr,
+                                 mode == Mode::READ ? OPEN_EXISTING : CREATE_ALWAYS,
+                                 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                 nullptr);
+        if (m_handle == INVALID_HANDLE_VALUE)
+        {
+            throwLastError("Cannot open " + path);
+        }
+#else
+        int flags = mode == Mode::READ ? O_RDONLY
+                  : mode == Mode::WRITE ? (O_WRONLY | O_CREAT | O_TRUNC)
+                  : (O_RDWR | O_CREAT | O_TRUNC);
+    #if defined(O_DIRECT)
+        if (directIo && mode == Mode::WRITE)
+        {
+            flags |= O_DIRECT;
+            m_direct = true;
+        }
+    #else
+        (void)directIo;
+    #endif
+        m_handle = ::open(path.c_str(), flags, 0644);
+    #if defined(O_DIRECT)
+        if (m_handle < 0 && m_direct)
+        {
+            // File system without O_DIRECT support, falls back to buffered I/O
+            m_direct = false;
+            m_handle = ::open(path.c_str(), flags & ~O_DIRECT, 0644);
+        }
+    #endif
+        if (m_handle < 0)
+        {
+            throwLastError("Cannot open " + path);
+        }
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Move-constructor.
+    ///=============================================================================
+    File(File&& other) noexcept
+        : m_handle(other.m_handle)
+        , m_direct(other.m_direct)
+        , m_owned(other.m_owned)
+    {
+        other.m_handle = invalidHandle();
+    }
+
+    ///=============================================================================
+    /// @brief Move-assignment operator.
+    ///=============================================================================
+    File& operator=(File&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            std::swap(m_handle, other.m_handle);
+            std::swap(m_direct, other.m_direct);
+            std::swap(m_owned, other.m_owned);
+        }
+        return *this;
+    }
+
+    // Forbids copying
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    ///=============================================================================
+    /// @brief Destructor. Closes the file.
+    ///=============================================================================
+    ~File() { close(); }
+
+    ///=============================================================================
+    /// @brief Gets the standard output of the process. It is written to with the
+    ///        same unbuffered write(), and is not closed by close().
+    ///
+    /// @return File - the standard output.
+    ///=============================================================================
+    static File standardOutput()
+    {
+#if defined(_WIN32)
+        File file(::GetStdHandle(STD_OUTPUT_HANDLE));
+#else
+        File file(STDOUT_FILENO);
+#endif
+        if (!file.isOpen())
+        {
+            throwLastError("No standard output");
+        }
+        return file;
+    }
+
+    ///=============================================================================
+    /// @brief Checks whether the file is open.
+    ///=============================================================================
+    bool isOpen() const noexcept { return m_handle != invalidHandle(); }
+
+    ///=============================================================================
+    /// @brief Checks whether writes bypass the page cache.
+    ///=============================================================================
+    bool isDirect() const noexcept { return m_direct; }
+
+    ///=============================================================================
+    /// @brief Closes the file. Does nothing if it is not open.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void close() noexcept
+    {
+        if (isOpen() && m_owned)
+        {
+#if defined(_WIN32)
+            ::CloseHandle(m_handle);
+#else
+            ::close(m_handle);
+#endif
+        }
+        m_handle = invalidHandle();
+        m_direct = false;
+        m_owned = true;
+    }
+
+    ///=============================================================================
+    /// @brief Switches the file back to buffered I/O, e.g. to write an unaligned
+    ///        tail after a series of direct writes.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void disableDirectIo()
+    {
+#if !defined(_WIN32) && defined(O_DIRECT)
+        if (m_direct)
+        {
+            const int flags = ::fcntl(m_handle, F_GETFL);
+            if (flags < 0 || ::fcntl(m_handle, F_SETFL, flags & ~O_DIRECT) < 0)
+            {
+                throwLastError("Cannot disable direct I/O");
+            }
+        }
+#endif
+        m_direct = false;
+    }
+
+    ///=============================================================================
+    /// @brief Gets size of the file in bytes.
+    ///
+    /// @return std::uint64_t - file size.
+    ///=============================================================================
+    std::uint64_t size() const
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(m_handle, &size))
+        {
+            throwLastError("Cannot get file size");
+        }
+        return static_cast<std::uint64_t>(size.QuadPart);
+#else
+        struct stat info;
+        if (::fstat(m_handle, &info) != 0)
+        {
+            throwLastError("Cannot get file size");
+        }
+        return static_cast<std::uint64_t>(info.st_size);
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Sets size of the file, extending it with zeros or truncating it.
+    ///
+    /// @param const std::uint64_t size - new size in bytes.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void resize(const std::uint64_t size)
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(size);
+        if (!::SetFilePointerEx(m_handle, position, nullptr, FILE_BEGIN) || !::SetEndOfFile(m_handle))
+        {
+            throwLastError("Cannot resize file");
+        }
+#else
+        if (::ftruncate(m_handle, static_cast<off_t>(size)) != 0)
+        {
+            throwLastError("Cannot resize file");
+        }
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Reads up to bytes bytes. Short only at the end of the file.
+    ///
+    /// @param void* buffer - destination.
+    /// @param const std::size_t bytes - number of bytes to read.
+    ///
+    /// @return std::size_t - number of bytes read, 0 at the end of the file.
+    ///=============================================================================
+    std::size_t read(void* buffer,
+                     const std::size_t bytes)
+    {
+        char* destination = static_cast<char*>(buffer);
+        std::size_t done = 0;
+        while (done < bytes)
+        {
+            const std::size_t chunk = clampChunk(bytes - done);
+#if defined(_WIN32)
+            DWORD count = 0;
+            if (!::ReadFile(m_handle, destination + done, static_cast<DWORD>(chunk), &count, nullptr))
+            {
+                throwLastError("Cannot read file");
+            }
+#else
+            const ssize_t count = ::read(m_handle, destination + done, chunk);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throwLastError("Cannot read file");
+            }
+#endif
+            if (count == 0)
+            {
+                break;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        return done;
+    }
+
+    ///=============================================================================
+    /// @brief Writes exactly bytes bytes.
+    ///
+    /// @param const void* buffer - source.
+    /// @param const std::size_t bytes - number of bytes to write.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void write(const void* buffer,
+               const std::size_t bytes)
+    {
+        const char* source = static_cast<const char*>(buffer);
+        std::size_t done = 0;
+        while (done < bytes)
+        {
+            const std::size_t chunk = clampChunk(bytes - done);
+#if defined(_WIN32)
+            DWORD count = 0;
+            if (!::WriteFile(m_handle, source + done, static_cast<DWORD>(chunk), &count, nullptr))
+            {
+                throwLastError("Cannot write file");
+            }
+#else
+            const ssize_t count = ::write(m_handle, source + done, chunk);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throwLastError("Cannot write file");
+            }
+#endif
+            done += static_cast<std::size_t>(count);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Writes exactly firstBytes of first, then secondBytes of second, in a
+    ///        single gathering call (writev) where the platform has one, so that
+    ///        a buffer and a large block need not be copied together first.
+    ///
+    /// @param const void* first - first source.
+    /// @param const std::size_t firstBytes - number of bytes of first.
+    /// @param const void* second - second source.
+    /// @param const std::size_t secondBytes - number of bytes of second.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void write(const void* first,
+               const std::size_t firstBytes,
+               const void* second,
+               const std::size_t secondBytes)
+    {
+#if defined(_WIN32)
+        write(first, firstBytes);
+        write(second, secondBytes);
+#else
+        struct iovec parts[2] =
+        {
+            { const_cast<void*>(first), firstBytes },
+            { const_cast<void*>(second), secondBytes }
+        };
+        std::size_t part = 0;
+        while (part < 2)
+        {
+            if (parts[part].iov_len == 0)
+            {
+                ++part;
+                continue;
+            }
+            // Short writes (e.g. beyond 2 GB on Linux) are resumed below
+            const ssize_t count = ::writev(m_handle, parts + part, static_cast<int>(2 - part));
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throwLastError("Cannot write file");
+            }
+            // Moves past the written bytes, which may end inside a part
+            std::size_t done = static_cast<std::size_t>(count);
+            for (; part < 2 && done >= parts[part].iov_len; ++part)
+            {
+                done -= parts[part].iov_len;
+            }
+            if (part < 2)
+            {
+                parts[part].iov_base = static_cast<char*>(parts[part].iov_base) + done;
+                parts[part].iov_len -= done;
+            }
+        }
+#endif
+    }
+
+#if defined(_WIN32)
+    ///=============================================================================
+    /// @brief Gets the native handle.
+    ///=============================================================================
+    HANDLE handle() const noexcept { return m_handle; }
+#else
+    ///=============================================================================
+    /// @brief Gets the native handle.
+    ///=============================================================================
+    int handle() const noexcept { return m_handle; }
+#endif
+
+    ///=============================================================================
+    /// @brief Throws std::system_error for the last OS error.
+    ///
+    /// @param const std::string& what - error description.
+    ///=============================================================================
+    [[noreturn]] static void throwLastError(const std::string& what)
+    {
+#if defined(_WIN32)
+        throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+#else
+        throw std::system_error(errno, std::generic_category(), what);
+#endif
+    }
+
+private:
+    ///=============================================================================
+    /// @brief Constructor. Wraps a handle which the file does not own.
+    ///=============================================================================
+#if defined(_WIN32)
+    explicit File(const HANDLE handle) noexcept
+#else
+    explicit File(const int handle) noexcept
+#endif
+        : m_handle(handle)
+        , m_direct(false)
+        , m_owned(false)
+    {
+#if defined(_WIN32)
+        if (m_handle == nullptr)
+        {
+            m_handle = invalidHandle();
+        }
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Value of a closed handle.
+    ///=============================================================================
+#if defined(_WIN32)
+    static HANDLE invalidHandle() noexcept { return INVALID_HANDLE_VALUE; }
+#else
+    static int invalidHandle() noexcept { return -1; }
+#endif
+
+    ///=============================================================================
+    /// @brief Limits a single OS call to 1 GB, which fits DWORD and ssize_t and
+    ///        keeps the direct I/O alignment.
+    ///=============================================================================
+    static std::size_t clampChunk(const std::size_t bytes) noexcept
+    {
+        const std::size_t maxChunk = std::size_t(1) << 30;
+        return bytes < maxChunk ? bytes : maxChunk;
+    }
+
+#if defined(_WIN32)
+    HANDLE m_handle;
+#else
+    int    m_handle;
+#endif
+    bool   m_direct;
+    bool   m_owned;    // false for the standard output
+};
+
+#endif // FILE_H
@@ -0,0 +1,158 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "File.h"
+
+#if !defined(_WIN32)
+    #include <sys/mman.h>
+#endif
+
+///=============================================================================
+/// Read-only memory mapping of a whole file. Pages are loaded lazily by the OS
+/// when they are touched, so a file larger than RAM can be walked through
+/// chunk by chunk without reading it into a buffer first.
+///
+/// Example of usage:
+/// MappedFile input("keys.bin");
+/// input.adviseSequential();
+/// const auto* keys = reinterpret_cast<const std::uint64_t*>(input.data());
+/// const std::size_t count = input.size() / sizeof(std::uint64_t);
+///=============================================================================
+class MappedFile
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor. Maps the file. Empty files get a null mapping.
+    ///
+    /// @param const std::string& path - path to the file.
+    ///=============================================================================
+    explicit MappedFile(const std::string& path)
+        : m_data(nullptr)
+        , m_size(0)
+#if defined(_WIN32)
+        , m_mapping(nullptr)
+#endif
+    {
+        File file(path, File::Mode::READ);
+        const std::uint64_t size = file.size();
+        if (size == 0)
+        {
+            return;
+        }
+        if (size > static_cast<std::uint64_t>(static_cast<std::size_t>(-1)))
+        {
+            throw std::system_error(std::make_error_code(std::errc::file_too_large),
+                                    "Cannot map " + path);
+        }
+        m_size = static_cast<std::size_t>(size);
+
+#if defined(_WIN32)
+        m_mapping = ::CreateFileMappingA(file.handle(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr)
+        {
+            File::throwLastError("Cannot map " + path);
+        }
+        m_data = static_cast<const unsigned char*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr)
+        {
+            ::CloseHandle(m_mapping);
+            File::throwLastError("Cannot map " + path);
+        }
+#else
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file.handle(), 0);
+        if (data == MAP_FAILED)
+        {
+            File::throwLastError("Cannot map " + path);
+        }
+        m_data = static_cast<const unsigned char*>(data);
+#endif
+        // The mapping keeps its own reference to the file, the handle is closed here
+    }
+
+    // Forbids copying
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ///=============================================================================
+    /// @brief Destructor. Unmaps the file.
+    ///=============================================================================
+    ~MappedFile()
+    {
+        if (m_data == nullptr)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        ::UnmapViewOfFile(m_data);
+        ::CloseHandle(m_mapping);
+#else
+        ::munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Gets the mapped bytes.
+    ///=============================================================================
+    const unsigned char* data() const noexcept { return m_data; }
+
+    ///=============================================================================
+    /// @brief Gets size of the mapping in bytes.
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_size; }
+
+    ///=============================================================================
+    /// @brief Hints the OS that the mapping is read sequentially (read-ahead).
+    ///
+    /// @return void.
+    ///=============================================================================
+    void adviseSequential() const noexcept
+    {
+#if !defined(_WIN32)
+        if (m_data != nullptr)
+        {
+            ::madvise(const_cast<unsigned char*>(m_data), m_size, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Hints the OS that the given bytes are not needed anymore, so their
+    ///        pages can be dropped before the memory budget is exceeded.
+    ///
+    /// @param const std::size_t offset - beginning of the bytes.
+    /// @param const std::size_t bytes - number of bytes.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void adviseDone(const std::size_t offset,
+                    const std::size_t bytes) const noexcept
+    {
+#if !defined(_WIN32)
+        // madvise() needs a page-aligned address
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t begin = offset / page * page;
+        if (m_data != nullptr && begin < m_size)
+        {
+            const std::size_t end = offset + bytes < m_size ? offset + bytes : m_size;
+            ::madvise(const_cast<unsigned char*>(m_data) + begin, end - begin, MADV_DONTNEED);
+        }
+#else
+        (void)offset;
+        (void)bytes;
+#endif
+    }
+
+private:
+    const unsigned char* m_data;
+    std::size_t          m_size;
+#if defined(_WIN32)
+    HANDLE               m_mapping;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,192 @@
+#ifndef MAPPEDOUTPUTFILE_H
+#define MAPPEDOUTPUTFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "File.h"
+
+#if !defined(_WIN32)
+    #include <sys/mman.h>
+#endif
+
+///=============================================================================
+/// Output file written through a memory mapping: the file is extended by a
+/// window at a time, the window is mapped and the bytes are copied into it,
+/// with no system call per write. The OS writes the dirty pages back in the
+/// background. close() unmaps the last window and truncates the file to the
+/// bytes actually written.
+///
+/// Errors are reported with std::system_error.
+///
+/// Example of usage:
+/// MappedOutputFile output("sorted.txt");
+/// output.write(text.data(), text.size());
+/// output.close();
+///=============================================================================
+class MappedOutputFile
+{
+public:
+    // Bytes mapped at a time
+    static constexpr std::size_t DEFAULT_WINDOW_SIZE = std::size_t(64) << 20;
+
+    // Windows are multiples of it: the allocation granularity of Windows, a
+    // multiple of the page size elsewhere
+    static constexpr std::size_t WINDOW_ALIGNMENT = std::size_t(64) << 10;
+
+    ///=============================================================================
+    /// @brief Constructor. Creates or truncates the file.
+    ///
+    /// @param const std::string& path - path to the file.
+    /// @param const std::size_t windowSize - bytes mapped at a time, rounded up
+    ///        to WINDOW_ALIGNMENT.
+    ///=============================================================================
+    explicit MappedOutputFile(const std::string& path,
+                              const std::size_t windowSize = DEFAULT_WINDOW_SIZE)
+        : m_file(path, File::Mode::READ_WRITE)
+        , m_windowSize((windowSize + WINDOW_ALIGNMENT - 1) / WINDOW_ALIGNMENT * WINDOW_ALIGNMENT)
+        , m_window(nullptr)
+        , m_windowOffset(0)
+        , m_windowUsed(0)
+    {
+        if (m_windowSize == 0)
+        {
+            m_windowSize = WINDOW_ALIGNMENT;
+        }
+    }
+
+    // Forbids copying
+    MappedOutputFile(const MappedOutputFile&) = delete;
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    ///=============================================================================
+    /// @brief Destructor. Closes the file, ignoring errors: call close() to get
+    ///        them.
+    ///=============================================================================
+    ~MappedOutputFile()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Appends bytes bytes.
+    ///
+    /// @param const void* buffer - source.
+    /// @param const std::size_t bytes - number of bytes to write.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void write(const void* buffer,
+               std::size_t bytes)
+    {
+        const char* source = static_cast<const char*>(buffer);
+        while (bytes != 0)
+        {
+            if (m_window == nullptr || m_windowUsed == m_windowSize)
+            {
+                mapNextWindow();
+            }
+            const std::size_t room = m_windowSize - m_windowUsed;
+            const std::size_t chunk = bytes < room ? bytes : room;
+            std::memcpy(m_window + m_windowUsed, source, chunk);
+            m_windowUsed += chunk;
+            source += chunk;
+            bytes -= chunk;
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Gets the number of bytes written so far.
+    ///=============================================================================
+    std::uint64_t size() const noexcept { return m_windowOffset + m_windowUsed; }
+
+    ///=============================================================================
+    /// @brief Unmaps the last window, cuts the file to size() and closes it.
+    ///        Does nothing if it is closed.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void close()
+    {
+        if (!m_file.isOpen())
+        {
+            return;
+        }
+        const std::uint64_t written = size();
+        unmap();
+        m_file.resize(written);
+        m_file.close();
+    }
+
+private:
+    ///=============================================================================
+    /// @brief Extends the file by a window past the current one and maps it.
+    ///=============================================================================
+    void mapNextWindow()
+    {
+        const std::uint64_t offset = m_window == nullptr && m_windowUsed == 0 ? m_windowOffset
+                                                                             : m_windowOffset + m_windowSize;
+        unmap();
+        m_windowOffset = offset;
+        m_windowUsed = 0;
+        const std::uint64_t end = offset + m_windowSize;
+        m_file.resize(end);
+#if defined(_WIN32)
+        HANDLE mapping = ::CreateFileMappingA(m_file.handle(), nullptr, PAGE_READWRITE,
+                                              static_cast<DWORD>(end >> 32), static_cast<DWORD>(end), nullptr);
+        if (mapping == nullptr)
+        {
+            File::throwLastError("Cannot map output file");
+        }
+        void* view = ::MapViewOfFile(mapping, FILE_MAP_WRITE,
+                                     static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), m_windowSize);
+        // The view keeps its own reference to the mapping
+        ::CloseHandle(mapping);
+        if (view == nullptr)
+        {
+            File::throwLastError("Cannot map output file");
+        }
+#else
+        void* view = ::mmap(nullptr, m_windowSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                            m_file.handle(), static_cast<off_t>(offset));
+        if (view == MAP_FAILED)
+        {
+            File::throwLastError("Cannot map output file");
+        }
+#endif
+        m_window = static_cast<char*>(view);
+    }
+
+    ///=============================================================================
+    /// @brief Unmaps the current window, if any.
+    ///=============================================================================
+    void unmap() noexcept
+    {
+        if (m_window == nullptr)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        ::UnmapViewOfFile(m_window);
+#else
+        ::munmap(m_window, m_windowSize);
+#endif
+        m_window = nullptr;
+    }
+
+    File          m_file;
+    std::size_t   m_windowSize;
+    char*         m_window;
+    std::uint64_t m_windowOffset;  // in the file, of the current window
+    std::size_t   m_windowUsed;    // bytes written into the current window
+};
+
+#endif // MAPPEDOUTPUTFILE_H
@@ -156,7 +156,7 @@ public:
     }
 
     ///=============================================================================
-    /// @brief Prints codes to the console.
+    /// @brief Prints codes to the console, one per line, and flushes once.
     ///
     /// @return void.
     ///=============================================================================
@@ -164,7 +164,26 @@ public:
     {
         for (const auto& code : m_objects)
         {
-            std::cout << code.second->getCode() << std::endl;
+            std::cout << code.second->getCode() << '\n';
+        }
+        std::cout.flush();
+    }
+
+    ///=============================================================================
+    /// @brief Writes codes, one per line.
+    ///
+    /// @param Writer& out - destination, a BufferedWriter (see
+    ///        IO\BufferedWriter.h) or alike.
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Writer>
+    void printCodes(Writer& out)
+    {
+        for (const auto& code : m_objects)
+        {
+            out.writeNumber(code.second->getCode());
+            out.write('\n');
         }
     }
 
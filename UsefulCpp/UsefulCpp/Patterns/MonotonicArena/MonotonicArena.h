@@ -0,0 +1,255 @@
+#ifndef MONOTONICARENA_H
+#define MONOTONICARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+///=============================================================================
+/// Monotonic (bump) arena: memory is handed out by moving a pointer through
+/// large chunks and is never given back one block at a time; release() (or
+/// the destructor) frees everything at once. An allocation is a few
+/// instructions, and objects which die together (the strings of a request, a
+/// parser pass) need no individual frees.
+///
+/// The first chunk may be a caller buffer, e.g. on the stack, so short-lived
+/// work does not touch the heap at all. Chunks which follow grow
+/// geometrically.
+///
+/// The arena is not thread-safe and must outlive everything allocated from
+/// it.
+///
+/// Example of usage:
+/// char initial[4096];
+/// MonotonicArena arena(initial, sizeof(initial));
+/// String<char, ArenaAllocator<char>> path("/var/lib/service/cache/entry",
+///                                         ArenaAllocator<char>(arena));
+/// std::vector<int, ArenaAllocator<int>> ids{ ArenaAllocator<int>(arena) };
+///=============================================================================
+class MonotonicArena
+{
+public:
+    // Size of the first heap chunk, if none is given
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    ///=============================================================================
+    /// @brief Constructor. Nothing is allocated until the first request.
+    ///
+    /// @param const std::size_t chunkSize - size of the first heap chunk.
+    ///=============================================================================
+    explicit MonotonicArena(const std::size_t chunkSize = DEFAULT_CHUNK_SIZE) noexcept
+        : m_initialBuffer(nullptr)
+        , m_initialSize(0)
+        , m_chunks(nullptr)
+        , m_current(nullptr)
+        , m_end(nullptr)
+        , m_nextChunkSize(chunkSize == 0 ? DEFAULT_CHUNK_SIZE : chunkSize)
+        , m_firstChunkSize(m_nextChunkSize)
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Serves the requests from the caller buffer first.
+    ///
+    /// @param void* buffer - caller-owned initial buffer.
+    /// @param const std::size_t size - size of the buffer in bytes.
+    ///=============================================================================
+    MonotonicArena(void* buffer,
+                   const std::size_t size) noexcept
+        : m_initialBuffer(static_cast<char*>(buffer))
+        , m_initialSize(size)
+        , m_chunks(nullptr)
+        , m_current(static_cast<char*>(buffer))
+        , m_end(static_cast<char*>(buffer) + size)
+        , m_nextChunkSize(size < DEFAULT_CHUNK_SIZE ? DEFAULT_CHUNK_SIZE : 2 * size)
+        , m_firstChunkSize(m_nextChunkSize)
+    {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ///=============================================================================
+    /// @brief Destructor. Frees all the chunks.
+    ///=============================================================================
+    ~MonotonicArena()
+    {
+        release();
+    }
+
+    ///=============================================================================
+    /// @brief Allocates a block. Throws std::bad_alloc if the memory is out.
+    ///
+    /// @param const std::size_t bytes - size of the block.
+    /// @param const std::size_t alignment - power of two alignment of the block.
+    ///
+    /// @return void* - the block.
+    ///=============================================================================
+    void* allocate(const std::size_t bytes,
+                   const std::size_t alignment = alignof(std::max_align_t))
+    {
+        char* block = align(m_current, alignment);
+        if (m_current == nullptr || block > m_end || bytes > static_cast<std::size_t>(m_end - block))
+        {
+            addChunk(bytes + alignment);
+            block = align(m_current, alignment);
+        }
+        m_current = block + bytes;
+        return block;
+    }
+
+    ///=============================================================================
+    /// @brief Does nothing: the memory comes back with release().
+    ///
+    /// @return void.
+    ///=============================================================================
+    void deallocate(void*, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {}
+
+    ///=============================================================================
+    /// @brief Frees every heap chunk at once. The caller buffer, if any, is
+    ///        reused from its beginning. Everything allocated before is invalid.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void release() noexcept
+    {
+        while (m_chunks != nullptr)
+        {
+            Chunk* next = m_chunks->next;
+            std::free(m_chunks);
+            m_chunks = next;
+        }
+        m_current = m_initialBuffer;
+        m_end = m_initialBuffer + m_initialSize;
+        m_nextChunkSize = m_firstChunkSize;
+    }
+
+private:
+    // Header at the beginning of every heap chunk
+    struct Chunk
+    {
+        Chunk* next;
+    };
+
+    ///=============================================================================
+    /// @brief Rounds the pointer up to the alignment.
+    ///=============================================================================
+    static char* align(char* pointer,
+                       const std::size_t alignment) noexcept
+    {
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+        return pointer + ((alignment - address % alignment) % alignment);
+    }
+
+    ///=============================================================================
+    /// @brief Starts a new heap chunk which fits at least required bytes.
+    ///=============================================================================
+    void addChunk(const std::size_t required)
+    {
+        std::size_t size = m_nextChunkSize;
+        while (size - sizeof(Chunk) < required)
+        {
+            size *= 2;
+        }
+        Chunk* chunk = static_cast<Chunk*>(std::malloc(size));
+        if (chunk == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        chunk->next = m_chunks;
+        m_chunks = chunk;
+        m_current = reinterpret_cast<char*>(chunk + 1);
+        m_end = reinterpret_cast<char*>(chunk) + size;
+        m_nextChunkSize = 2 * size;
+    }
+
+    char*       m_initialBuffer;    // caller-owned, may be null
+    std::size_t m_initialSize;
+    Chunk*      m_chunks;           // heap chunks, the newest first
+    char*       m_current;          // free part of the current chunk
+    char*       m_end;
+    std::size_t m_nextChunkSize;
+    std::size_t m_firstChunkSize;
+};
+
+///=============================================================================
+/// Standard allocator over a MonotonicArena, for String and the standard
+/// containers. deallocate() is a no-op, so containers which reallocate often
+/// leave their old buffers in the arena until it is released: reserve() up
+/// front where the size is known.
+///
+/// Copies share the arena and compare equal; the allocator does not propagate
+/// on assignment, so a string assigned from another arena copies characters
+/// into its own one.
+///=============================================================================
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param MonotonicArena& arena - arena which provides the memory.
+    ///=============================================================================
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept
+        : m_arena(&arena)
+    {}
+
+    ///=============================================================================
+    /// @brief Rebinding constructor.
+    ///=============================================================================
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : m_arena(other.arena())
+    {}
+
+    ///=============================================================================
+    /// @brief Allocates room for n objects.
+    ///
+    /// @param const std::size_t n - number of objects.
+    ///
+    /// @return T* - uninitialized storage.
+    ///=============================================================================
+    T* allocate(const std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    ///=============================================================================
+    /// @brief Does nothing: the memory comes back when the arena is released.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void deallocate(T*, std::size_t) noexcept {}
+
+    ///=============================================================================
+    /// @brief Gets the arena.
+    ///=============================================================================
+    MonotonicArena* arena() const noexcept { return m_arena; }
+
+private:
+    MonotonicArena* m_arena;
+};
+
+///=============================================================================
+///=============================================================================
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept
+{
+    return lhs.arena() == rhs.arena();
+}
+
+///=============================================================================
+///=============================================================================
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept
+{
+    return lhs.arena() != rhs.arena();
+}
+
+#endif // MONOTONICARENA_H
@@ -0,0 +1,127 @@
+#ifndef HASHEDSTRING_H
+#define HASHEDSTRING_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "String.h"
+
+///=============================================================================
+/// String with its hash computed once and stored next to it, for keys which
+/// are hashed or compared many times: lookups in several tables, rehashing,
+/// and equality, which compares the hashes before the characters.
+///
+/// The cache lives in this wrapper rather than in String, so that strings
+/// which are never hashed do not pay for it. The string is immutable while it
+/// is wrapped, which keeps the hash valid and lets several threads read it;
+/// release() gives the String back for modification.
+///
+/// Example of usage:
+/// std::unordered_set<HashedCString> keywords;
+/// keywords.emplace(CString("select"));
+/// HashedCString token(readToken());
+/// if (keywords.count(token) != 0) { ... }   // hashed once, when created
+///=============================================================================
+template <typename CharT, typename Allocator = std::allocator<CharT>>
+class HashedString
+{
+public:
+    using StringType = String<CharT, Allocator>;
+
+    ///=============================================================================
+    /// @brief Default constructor. Wraps an empty string.
+    ///=============================================================================
+    HashedString()
+        : m_hash(StringKernels::hash(m_str.begin(), 0))
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Takes the string and computes its hash.
+    ///
+    /// @param StringType str - the string.
+    ///=============================================================================
+    explicit HashedString(StringType str)
+        : m_str(std::move(str))
+        , m_hash(StringKernels::hash(m_str.begin(), m_str.size()))
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Copies the characters of a view.
+    ///
+    /// @param const BasicStringView<CharT> view - characters.
+    ///=============================================================================
+    explicit HashedString(const BasicStringView<CharT> view)
+        : HashedString(StringType(view))
+    {}
+
+    ///=============================================================================
+    /// @brief Gets the string.
+    ///=============================================================================
+    const StringType& str() const noexcept { return m_str; }
+
+    ///=============================================================================
+    /// @brief Gets a view of the characters.
+    ///=============================================================================
+    BasicStringView<CharT> view() const noexcept { return m_str.view(); }
+    operator BasicStringView<CharT>() const noexcept { return m_str.view(); }
+
+    ///=============================================================================
+    /// @brief Gets the stored hash, equal to std::hash of the String.
+    ///=============================================================================
+    std::size_t hash() const noexcept { return m_hash; }
+
+    ///=============================================================================
+    /// @brief Gets the number of characters.
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_str.size(); }
+
+    ///=============================================================================
+    /// @brief Takes the string out, for modification. The wrapper is left empty.
+    ///
+    /// @return StringType - the string.
+    ///=============================================================================
+    StringType release()
+    {
+        StringType str(std::move(m_str));
+        m_str.clear();
+        m_hash = StringKernels::hash(m_str.begin(), 0);
+        return str;
+    }
+
+    ///=============================================================================
+    /// @brief Compares the hashes first, the characters only when they match.
+    ///=============================================================================
+    friend bool operator==(const HashedString& lhs, const HashedString& rhs)
+    {
+        return lhs.m_hash == rhs.m_hash && lhs.m_str.equals(rhs.m_str);
+    }
+
+    friend bool operator!=(const HashedString& lhs, const HashedString& rhs) { return !(lhs == rhs); }
+    friend bool operator<(const HashedString& lhs, const HashedString& rhs) { return lhs.m_str < rhs.m_str; }
+
+private:
+    StringType  m_str;
+    std::size_t m_hash;
+};
+
+using HashedCString = HashedString<char>;
+using HashedWString = HashedString<wchar_t>;
+
+///=============================================================================
+/// Hash of a HashedString: the stored one.
+///=============================================================================
+namespace std
+{
+    template <typename CharT, typename Allocator>
+    struct hash<HashedString<CharT, Allocator>>
+    {
+        std::size_t operator()(const HashedString<CharT, Allocator>& str) const noexcept
+        {
+            return str.hash();
+        }
+    };
+}
+
+#endif // HASHEDSTRING_H
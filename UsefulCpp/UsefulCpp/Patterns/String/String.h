@@ -1,170 +1,618 @@
 #ifndef STRING_H
 #define STRING_H
 
+#include <algorithm>
 #include <cstring> // for strlen(), memcpy(), memset() and etc...
+#include <memory>    // for std::allocator_traits
 #include <stdexcept>
+#include <string>    // for std::char_traits
+#include <type_traits>
+
+#include "StringSearch.h"
+#include "StringView.h"
+
+template <typename StringT, typename Lhs, typename Rhs>
+class StringConcat;
 
 ///=============================================================================
-/// Simple string implementation. No SSO for now. String does not contain null
-/// terminator '\0'. But if data() or c_str() is being called, it will be appen-
-/// ded.
+/// Simple string implementation with small string optimization (SSO): strings
+/// of up to LOCAL_CAPACITY characters are kept inside the object itself, so
+/// creating, copying, moving and destroying them never touches the heap.
+/// Longer strings live in a heap buffer, whose capacity takes the place of the
+/// local characters.
+///
+/// Heap buffers come from the Allocator (std::allocator by default), e.g. from
+/// an arena which releases all the strings of a request at once:
+/// MonotonicArena arena;
+/// String<char, ArenaAllocator<char>> name("a rather long request parameter",
+///                                         ArenaAllocator<char>(arena));
+///
+/// Concatenation is lazy: a + b + c builds a StringConcat expression (see
+/// StringConcat.h) which is turned into a String with a single allocation.
+///
+/// The characters are always followed by a null terminator (there is always
+/// room for it), so c_str() only hands out the pointer. Slices and read-only
+/// parameters should be a BasicStringView (see StringView.h), to which String
+/// converts without a copy; substr() returns one.
 ///=============================================================================
-template <typename CharT>
-class String
+template <typename CharT, typename Allocator = std::allocator<CharT>>
+class String : private Allocator    // empty base: a stateless allocator takes no room
 {
+    static_assert(std::is_same<typename std::allocator_traits<Allocator>::value_type, CharT>::value,
+                  "String: Allocator must allocate CharT");
+
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
 public:
+    using value_type = CharT;
+
+    // Returned by the searches when nothing is found
+    static constexpr std::size_t npos = StringKernels::NOT_FOUND;
+
+    // Number of characters which are stored without a heap allocation
+    static constexpr std::size_t LOCAL_CAPACITY = 16 / sizeof(CharT) - 1;
+
     ///=============================================================================
-    /// @brief Default constructor. Creates an empty string object.
+    /// @brief Constructor. Creates an empty string which takes its heap buffers
+    ///        from the given allocator.
+    ///
+    /// @param const Allocator& allocator - allocator of the heap buffers.
     ///=============================================================================
-    String(const std::size_t size = 0)
-        : m_size(size)
-        , m_capacity(size)
-        , m_data(new CharT[size])
-    {}
+    explicit String(const Allocator& allocator) noexcept
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(0)
+    {
+        m_local[0] = CharT();
+    }
+
+    ///=============================================================================
+    /// @brief Default constructor. Creates a string of size null characters.
+    ///
+    /// @param const std::size_t size - number of characters.
+    /// @param const Allocator& allocator - allocator of the heap buffers.
+    ///=============================================================================
+    String(const std::size_t size = 0,
+           const Allocator& allocator = Allocator())
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(0)
+    {
+        reserve(size);
+        std::fill(m_data, m_data + size + 1, CharT());
+        m_size = size;
+    }
 
     ///=============================================================================
     /// @brief Constructor. Plain character is passed.
     ///
     /// @param CharT c - character.
+    /// @param const Allocator& allocator - allocator of the heap buffers.
     ///=============================================================================
-    explicit String(CharT c)
-        : m_size(1)
-        , m_capacity(2)
-        , m_data(new CharT(c))
-    {}
+    explicit String(CharT c,
+                    const Allocator& allocator = Allocator())
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(1)
+    {
+        m_local[0] = c;
+        m_local[1] = CharT();
+    }
 
     ///=============================================================================
     /// @brief Constructor. C-String is passed.
     ///
     /// @param const CharT* data - c-style string.
+    /// @param const Allocator& allocator - allocator of the heap buffers.
     ///=============================================================================
-    explicit String(const CharT* data) noexcept
-        : m_size(strlen(data))
-        , m_capacity(strlen(data))
-        , m_data(data)
-    {}
+    explicit String(const CharT* data,
+                    const Allocator& allocator = Allocator())
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(0)
+    {
+        assign(data, std::char_traits<CharT>::length(data));
+    }
+
+    ///=============================================================================
+    /// @brief Constructor. Copies the characters of a view.
+    ///
+    /// @param const BasicStringView<CharT> view - characters to copy.
+    /// @param const Allocator& allocator - allocator of the heap buffers.
+    ///=============================================================================
+    explicit String(const BasicStringView<CharT> view,
+                    const Allocator& allocator = Allocator())
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(0)
+    {
+        assign(view.data(), view.size());
+    }
 
     ///=============================================================================
     /// @brief Copy-constructor.
     /// 
-    /// @param const String<CharT>& str - read-only reference to another String.
+    /// @param const String& str - read-only reference to another String.
+    ///=============================================================================
+    String(const String& str)
+        : Allocator(AllocatorTraits::select_on_container_copy_construction(str.allocator()))
+        , m_data(m_local)
+        , m_size(0)
+    {
+        assign(str.m_data, str.m_size);
+    }
+
     ///=============================================================================
-    String(const String<CharT>& str)
-        : m_size(str.length())
-        , m_capacity(str.length() + 1)
-        , m_data(new CharT(str.data()))
-    {}
+    /// @brief Copy-constructor with another allocator.
+    ///
+    /// @param const String& str - read-only reference to another String.
+    /// @param const Allocator& allocator - allocator of the heap buffers.
+    ///=============================================================================
+    String(const String& str,
+           const Allocator& allocator)
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(0)
+    {
+        assign(str.m_data, str.m_size);
+    }
 
     ///=============================================================================
-    /// @brief Move-constructor.
+    /// @brief Move-constructor. Takes over the heap buffer of a long string, copies
+    ///        the characters of a short one.
     ///
-    /// @param String<CharT>&& str - rv-reference to another String.
+    /// @param String&& str - rv-reference to another String.
     ///=============================================================================
-    String(String<CharT>&& str) noexcept
-        : m_size(str.length())
-        , m_capacity(str.length())
-        , m_data(std::move(str.data()))
-    {}
+    String(String&& str) noexcept
+        : Allocator(std::move(str.allocator()))
+        , m_data(m_local)
+        , m_size(0)
+    {
+        steal(str);
+    }
+
+    ///=============================================================================
+    /// @brief Constructor. Materializes a concatenation expression: one
+    ///        allocation of the total length, one copy of every piece.
+    ///
+    /// @param const StringConcat<String, Lhs, Rhs>& expression - a + b + ...
+    /// @param const Allocator& allocator - allocator of the heap buffers.
+    ///=============================================================================
+    template <typename Lhs, typename Rhs>
+    String(const StringConcat<String, Lhs, Rhs>& expression,
+           const Allocator& allocator = Allocator())
+        : Allocator(allocator)
+        , m_data(m_local)
+        , m_size(0)
+    {
+        const std::size_t size = expression.size();
+        reserve(size);
+        expression.copyTo(m_data);
+        m_size = size;
+        m_data[m_size] = CharT();
+    }
 
     ///=============================================================================
     /// @brief Destructor. Deletes heap-allocated string.
     ///=============================================================================
     ~String()
     {
-        if (data)
+        deallocate();
+    }
+
+    //======================== operators ================================
+
+    ///=============================================================================
+    ///=============================================================================
+    String& operator=(const String& str)
+    {
+        if (this != &str)
         {
-            delete m_data;
+            if (AllocatorTraits::propagate_on_container_copy_assignment::value &&
+                allocator() != str.allocator())
+            {
+                // The buffer must go back to the allocator which gave it
+                deallocate();
+                m_data = m_local;
+                m_size = 0;
+                copyAllocator(str, typename AllocatorTraits::propagate_on_container_copy_assignment());
+            }
+            assign(str.m_data, str.m_size);
         }
+        return *this;
     }
 
-    //======================== operators ================================
+    ///=============================================================================
+    ///=============================================================================
+    String& operator=(String&& str) noexcept(AllocatorTraits::propagate_on_container_move_assignment::value ||
+                                             AllocatorTraits::is_always_equal::value)
+    {
+        if (this == &str)
+        {
+            return *this;
+        }
+        if (AllocatorTraits::propagate_on_container_move_assignment::value ||
+            allocator() == str.allocator())
+        {
+            deallocate();
+            m_data = m_local;
+            m_size = 0;
+            moveAllocator(str, typename AllocatorTraits::propagate_on_container_move_assignment());
+            steal(str);
+        }
+        else
+        {
+            // A buffer of another allocator cannot be taken over
+            assign(str.m_data, str.m_size);
+        }
+        return *this;
+    }
 
     ///=============================================================================
+    /// @brief Assigns a concatenation expression, which may refer to this string.
     ///=============================================================================
-    String<CharT>& operator=(const String<CharT>& str)
+    template <typename Lhs, typename Rhs>
+    String& operator=(const StringConcat<String, Lhs, Rhs>& expression)
     {
-        m_capacity = str.length() + 1; // for '\0'
-        
-        // Memory reallocation with a new capacity value
-        delete m_data;
-        m_data = new CharT[m_capacity];
+        return *this = String(expression, allocator());
+    }
 
-        // Assigning new data
-        std::memcpy(m_data, str.c_str(), m_capacity - 1);
+    ///=============================================================================
+    ///=============================================================================
+    String& operator+=(const String& str)
+    {
+        return append(str);
+    }
 
-        return *this;
+    ///=============================================================================
+    ///=============================================================================
+    String& operator+=(const BasicStringView<CharT> view)
+    {
+        return append(view.data(), view.size());
     }
 
     ///=============================================================================
     ///=============================================================================
-    String<CharT>& operator+=(const String<CharT>& str)
-    {   
-        // Checks whether we have enough of remaining capacity or not
-        if ((m_capacity - m_size) >= str.length())
-        {
+    template <typename Lhs, typename Rhs>
+    String& operator+=(const StringConcat<String, Lhs, Rhs>& expression)
+    {
+        return append(expression);
+    }
 
+    ///=============================================================================
+    ///=============================================================================
+    String& operator+=(const CharT* cstr)
+    {
+        return append(cstr);
+    }
 
-        }
-        //     +1?
-        m_capacity += str.length() + 1;
+    ///=============================================================================
+    ///=============================================================================
+    String& operator+=(const CharT c)
+    {
+        push_back(c);
+        return *this;
+    }
 
-        CharT* tmp = m_data;
-        delete m_data;
-        m_data = new CharT[m_capacity];
+    ///=============================================================================
+    ///=============================================================================
+    CharT& operator[](const std::size_t index)
+    {
+        return *(m_data + index);
+    }
 
-        // Copies old data
-        std::memcpy(m_data, tmp, tmp.length());
+    ///=============================================================================
+    ///=============================================================================
+    const CharT& operator[](const std::size_t index) const
+    {
+        return *(m_data + index);
+    }
 
-        // Copies new data, starting from the end position of the old data
-        std::memcpy(&*(m_data + tmp.length()), str.c_str(), str.length() + 1);
+    //================================= Appending ==================================
 
+    ///=============================================================================
+    /// @brief Appends size characters. The characters are copied once: straight
+    ///        into the spare capacity, or into the new buffer together with the
+    ///        old content when the string has to grow. Growth is geometric, so n
+    ///        appends cost O(n) amortized. data may point into the string itself.
+    ///
+    /// @param const CharT* data - characters to append.
+    /// @param const std::size_t size - number of characters.
+    ///
+    /// @return String& - this string.
+    ///=============================================================================
+    String& append(const CharT* data,
+                   const std::size_t size)
+    {
+        if (size > capacity() - m_size)
+        {
+            // The old buffer is released only after data has been copied
+            const std::size_t newCapacity = grownCapacity(m_size + size);
+            CharT* buffer = allocate(newCapacity);
+            std::memcpy(buffer, m_data, m_size * sizeof(CharT));
+            std::memcpy(buffer + m_size, data, size * sizeof(CharT));
+            deallocate();
+            m_data = buffer;
+            m_capacity = newCapacity;
+        }
+        else
+        {
+            std::memcpy(m_data + m_size, data, size * sizeof(CharT));
+        }
+        m_size += size;
+        m_data[m_size] = CharT();
         return *this;
     }
 
     ///=============================================================================
+    /// @brief Appends another String (or the string itself).
+    ///
+    /// @param const String& str - string to append.
+    ///
+    /// @return String& - this string.
+    ///=============================================================================
+    String& append(const String& str)
+    {
+        return append(str.m_data, str.m_size);
+    }
+
+    ///=============================================================================
+    /// @brief Appends the characters of a view, which may refer to this string.
+    ///
+    /// @param const BasicStringView<CharT> view - characters to append.
+    ///
+    /// @return String& - this string.
+    ///=============================================================================
+    String& append(const BasicStringView<CharT> view)
+    {
+        return append(view.data(), view.size());
+    }
+
+    ///=============================================================================
+    /// @brief Appends a c-style string.
+    ///
+    /// @param const CharT* cstr - null-terminated string.
+    ///
+    /// @return String& - this string.
+    ///=============================================================================
+    String& append(const CharT* cstr)
+    {
+        return append(cstr, std::char_traits<CharT>::length(cstr));
+    }
+
+    ///=============================================================================
+    /// @brief Appends a single character.
+    ///
+    /// @param const CharT c - character.
+    ///
+    /// @return String& - this string.
     ///=============================================================================
-    String<CharT>& operator+=(const CharT* cstr)
+    String& append(const CharT c)
     {
-        
+        push_back(c);
+        return *this;
     }
 
     ///=============================================================================
+    /// @brief Appends a concatenation expression, which may refer to this string:
+    ///        at most one allocation, every piece is copied once.
+    ///
+    /// @param const StringConcat<String, Lhs, Rhs>& expression - a + b + ...
+    ///
+    /// @return String& - this string.
     ///=============================================================================
-    String<CharT>& operator+=(const CharT c)
+    template <typename Lhs, typename Rhs>
+    String& append(const StringConcat<String, Lhs, Rhs>& expression)
     {
-        if (c == '\0')
+        const std::size_t size = expression.size();
+        if (size > capacity() - m_size)
         {
-            *(m_data + m_size) = '\0';
+            // The old buffer is released only after the pieces have been copied
+            const std::size_t newCapacity = grownCapacity(m_size + size);
+            CharT* buffer = allocate(newCapacity);
+            std::memcpy(buffer, m_data, m_size * sizeof(CharT));
+            expression.copyTo(buffer + m_size);
+            deallocate();
+            m_data = buffer;
+            m_capacity = newCapacity;
         }
         else
         {
+            expression.copyTo(m_data + m_size);
+        }
+        m_size += size;
+        m_data[m_size] = CharT();
+        return *this;
+    }
 
+    ///=============================================================================
+    /// @brief Appends a single character. Amortized O(1).
+    ///
+    /// @param const CharT c - character.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void push_back(const CharT c)
+    {
+        if (m_size == capacity())
+        {
+            reserve(grownCapacity(m_size + 1));
         }
+        m_data[m_size++] = c;
+        m_data[m_size] = CharT();
+    }
 
+    //======================== Comparison and searching ============================
+    // Vectorized (see StringSearch.h); the terminator is neither needed nor
+    // written.
+
+    ///=============================================================================
+    /// @brief Three-way lexicographical comparison with another string.
+    ///
+    /// @param const String& str - string to compare with.
+    ///
+    /// @return int - negative if this string goes first, 0 if the strings are
+    ///               equal, positive otherwise.
+    ///=============================================================================
+    int compare(const String& str) const
+    {
+        return StringKernels::compare(m_data, m_size, str.m_data, str.m_size);
     }
 
     ///=============================================================================
+    /// @brief Checks whether the strings have the same characters.
+    ///
+    /// @param const String& str - string to compare with.
+    ///
+    /// @return true if the strings are equal.
     ///=============================================================================
-    CharT& operator[](const std::size_t index)
+    bool equals(const String& str) const
     {
-        return *(m_data + index);
+        return StringKernels::equal(m_data, m_size, str.m_data, str.m_size);
     }
 
     ///=============================================================================
+    /// @brief Finds the first occurrence of a character at or after pos.
+    ///
+    /// @param const CharT c - character to find.
+    /// @param const std::size_t pos - position to start at.
+    ///
+    /// @return std::size_t - index of the character, or npos.
     ///=============================================================================
-    const CharT& operator[](const std::size_t index) const
+    std::size_t find(const CharT c,
+                     const std::size_t pos = 0) const
     {
-        return *(m_data + index);
+        return StringKernels::find(m_data, m_size, c, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of count characters at or after pos.
+    ///
+    /// @param const CharT* str - characters to find.
+    /// @param const std::size_t pos - position to start at.
+    /// @param const std::size_t count - number of characters.
+    ///
+    /// @return std::size_t - index of the substring, or npos.
+    ///=============================================================================
+    std::size_t find(const CharT* str,
+                     const std::size_t pos,
+                     const std::size_t count) const
+    {
+        return StringKernels::find(m_data, m_size, str, count, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of a c-string at or after pos.
+    ///=============================================================================
+    std::size_t find(const CharT* cstr,
+                     const std::size_t pos = 0) const
+    {
+        return find(cstr, pos, std::char_traits<CharT>::length(cstr));
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of another string at or after pos.
+    ///=============================================================================
+    std::size_t find(const String& str,
+                     const std::size_t pos = 0) const
+    {
+        return find(str.m_data, pos, str.m_size);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of a character at or before pos.
+    ///
+    /// @param const CharT c - character to find.
+    /// @param const std::size_t pos - last position to check.
+    ///
+    /// @return std::size_t - index of the character, or npos.
+    ///=============================================================================
+    std::size_t rfind(const CharT c,
+                      const std::size_t pos = npos) const
+    {
+        return StringKernels::rfind(m_data, m_size, c, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of count characters which starts at or
+    ///        before pos.
+    ///
+    /// @param const CharT* str - characters to find.
+    /// @param const std::size_t pos - last position to start at.
+    /// @param const std::size_t count - number of characters.
+    ///
+    /// @return std::size_t - index of the substring, or npos.
+    ///=============================================================================
+    std::size_t rfind(const CharT* str,
+                      const std::size_t pos,
+                      const std::size_t count) const
+    {
+        return StringKernels::rfind(m_data, m_size, str, count, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of a c-string at or before pos.
+    ///=============================================================================
+    std::size_t rfind(const CharT* cstr,
+                      const std::size_t pos = npos) const
+    {
+        return rfind(cstr, pos, std::char_traits<CharT>::length(cstr));
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of another string at or before pos.
+    ///=============================================================================
+    std::size_t rfind(const String& str,
+                      const std::size_t pos = npos) const
+    {
+        return rfind(str.m_data, pos, str.m_size);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first character at or after pos which is one of count
+    ///        given characters.
+    ///
+    /// @param const CharT* set - characters to look for.
+    /// @param const std::size_t pos - position to start at.
+    /// @param const std::size_t count - number of characters in the set.
+    ///
+    /// @return std::size_t - index of the character, or npos.
+    ///=============================================================================
+    std::size_t find_first_of(const CharT* set,
+                              const std::size_t pos,
+                              const std::size_t count) const
+    {
+        return StringKernels::findFirstOf(m_data, m_size, set, count, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first character at or after pos which is one of the
+    ///        characters of a c-string.
+    ///=============================================================================
+    std::size_t find_first_of(const CharT* set,
+                              const std::size_t pos = 0) const
+    {
+        return find_first_of(set, pos, std::char_traits<CharT>::length(set));
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first character at or after pos which is one of the
+    ///        characters of another string.
+    ///=============================================================================
+    std::size_t find_first_of(const String& set,
+                              const std::size_t pos = 0) const
+    {
+        return find_first_of(set.m_data, pos, set.m_size);
     }
 
     //============================= Additional methods =============================
 
     ///=============================================================================
-    /// @brief Gets content of 
+    /// @brief Gets the character at the given position, with bounds checking.
     ///=============================================================================
-    inline CharT& at(const std::size_t n) const
+    inline const CharT& at(const std::size_t n) const
     {
-        if (m_size >= n) { throw std::out_of_range; }
+        if (n >= m_size) { throw std::out_of_range("String::at"); }
         return operator[](n);
     }
 
@@ -185,39 +633,275 @@ public:
 
     ///=============================================================================
     ///=============================================================================
-    inline std::size_t capacity() const noexcept { return m_capacity; }
+    inline std::size_t capacity() const noexcept { return isLocal() ? LOCAL_CAPACITY : m_capacity; }
+
+    ///=============================================================================
+    /// @brief Gets the characters, without the terminator.
+    ///=============================================================================
+    inline CharT* begin() noexcept { return m_data; }
+    inline const CharT* begin() const noexcept { return m_data; }
+    inline CharT* end() noexcept { return m_data + m_size; }
+    inline const CharT* end() const noexcept { return m_data + m_size; }
+
+    //================================ Views =======================================
+    // Views refer to the characters of the string: they are invalidated by
+    // anything which reallocates it.
+
+    ///=============================================================================
+    /// @brief Gets a view of the whole string, without a copy.
+    ///=============================================================================
+    BasicStringView<CharT> view() const noexcept { return BasicStringView<CharT>(m_data, m_size); }
+
+    ///=============================================================================
+    /// @brief Converts to a view of the whole string, without a copy.
+    ///=============================================================================
+    operator BasicStringView<CharT>() const noexcept { return view(); }
+
+    ///=============================================================================
+    /// @brief Gets a view of up to count characters from pos, without a copy.
+    ///
+    /// @param const std::size_t pos - first character, not greater than size().
+    /// @param const std::size_t count - number of characters, npos for the rest.
+    ///
+    /// @return BasicStringView<CharT> - the slice.
+    ///=============================================================================
+    BasicStringView<CharT> substr(const std::size_t pos = 0,
+                                  const std::size_t count = npos) const
+    {
+        return view().substr(pos, count);
+    }
+
+    ///=============================================================================
+    /// @brief Splits the string by a character into views (see StringSplit).
+    ///
+    /// @param const CharT delimiter - separator of the tokens.
+    ///
+    /// @return StringSplit<CharT> - range of the tokens.
+    ///=============================================================================
+    StringSplit<CharT> split(const CharT delimiter) const noexcept
+    {
+        return StringSplit<CharT>(view(), delimiter);
+    }
+
+    ///=============================================================================
+    /// @brief Splits the string by a substring into views (see StringSplit).
+    ///
+    /// @param const BasicStringView<CharT> delimiter - separator of the tokens.
+    ///
+    /// @return StringSplit<CharT> - range of the tokens.
+    ///=============================================================================
+    StringSplit<CharT> split(const BasicStringView<CharT> delimiter) const noexcept
+    {
+        return StringSplit<CharT>(view(), delimiter);
+    }
 
     ///=============================================================================
     /// @brief Equivalent of c_str().
     ///
     /// @return const CharT* m_data - c-string.
     ///=============================================================================
-    inline const CharT* data() const noexcept { return c_str(); }
+    inline const CharT* data() const noexcept { return m_data; }
 
     ///=============================================================================
-    /// @brief Returns c-string. Appends teminating null.
+    /// @brief Returns c-string. The terminator is always in place, nothing is
+    ///        written.
     ///
     /// @return const CharT* m_data - c-string.
     ///=============================================================================
-    inline const CharT* c_str() const noexcept
+    inline const CharT* c_str() const noexcept { return m_data; }
+
+    ///=============================================================================
+    /// @brief Makes room for at least n characters. Short strings stay local.
+    ///
+    /// @param std::size_t n - number of characters.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void reserve(std::size_t n)
     {
-        *(m_data + m_size) = '\0';
-        return m_data;
+        if (n <= capacity()) { return; }
+
+        CharT* data = allocate(n);
+        std::memcpy(data, m_data, (m_size + 1) * sizeof(CharT));
+        deallocate();
+        m_data = data;
+        m_capacity = n;
     }
 
     ///=============================================================================
+    /// @brief Releases the unused capacity. A string which fits LOCAL_CAPACITY
+    ///        moves back into the object.
+    ///
+    /// @return void.
     ///=============================================================================
-    void reserve(std::size_t n)
+    void shrink_to_fit()
     {
-        if (m_capacity >= capacity) { return; }
+        if (isLocal() || m_capacity == m_size) { return; }
 
-        new CharT[capacity];
+        CharT* heap = m_data;
+        const std::size_t heapCapacity = m_capacity;
+        if (m_size <= LOCAL_CAPACITY)
+        {
+            m_data = m_local;
+            std::memcpy(m_local, heap, (m_size + 1) * sizeof(CharT));
+        }
+        else
+        {
+            m_data = allocate(m_size);
+            std::memcpy(m_data, heap, (m_size + 1) * sizeof(CharT));
+            m_capacity = m_size;
+        }
+        deallocate(heap, heapCapacity);
     }
 
+    ///=============================================================================
+    /// @brief Removes all characters. The capacity is kept.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void clear() noexcept
+    {
+        m_size = 0;
+        m_data[0] = CharT();
+    }
+
+    ///=============================================================================
+    /// @brief Lets op write the characters in place: makes room for count
+    ///        characters and calls op(data, count), which may keep or overwrite
+    ///        the current characters and returns the new size (at most count).
+    ///        Characters past the current size are not initialized.
+    ///
+    /// @param const std::size_t count - number of characters op may write.
+    /// @param Operation op - writer, std::size_t(CharT* data, std::size_t count).
+    ///
+    /// @return void.
+    ///=============================================================================
+    template <typename Operation>
+    void resize_and_overwrite(const std::size_t count,
+                              Operation op)
+    {
+        if (count > capacity())
+        {
+            reserve(grownCapacity(count));
+        }
+        m_size = op(m_data, count);
+        m_data[m_size] = CharT();
+    }
+
+    ///=============================================================================
+    /// @brief Gets a copy of the allocator of the heap buffers.
+    ///=============================================================================
+    Allocator get_allocator() const { return allocator(); }
+
+    ///=============================================================================
+    /// @brief Checks whether the characters are stored inside the object.
+    ///
+    /// @return true if no heap buffer is owned.
+    ///=============================================================================
+    inline bool isLocal() const noexcept { return m_data == m_local; }
+
 private:
+    ///=============================================================================
+    /// @brief Gets the allocator (the empty base).
+    ///=============================================================================
+    Allocator& allocator() noexcept { return *this; }
+    const Allocator& allocator() const noexcept { return *this; }
+
+    ///=============================================================================
+    /// @brief Take the allocator of str over, if the allocator propagates on
+    ///        copy or move assignment respectively.
+    ///=============================================================================
+    void copyAllocator(const String& str, std::true_type) { allocator() = str.allocator(); }
+    void copyAllocator(const String&, std::false_type) noexcept {}
+    void moveAllocator(String& str, std::true_type) noexcept { allocator() = std::move(str.allocator()); }
+    void moveAllocator(String&, std::false_type) noexcept {}
+
+    ///=============================================================================
+    /// @brief Allocates a heap buffer of n characters plus the terminator.
+    ///=============================================================================
+    CharT* allocate(const std::size_t n)
+    {
+        return AllocatorTraits::allocate(allocator(), n + 1);
+    }
+
+    ///=============================================================================
+    /// @brief Returns a heap buffer of capacity characters (plus the terminator)
+    ///        to the allocator.
+    ///=============================================================================
+    void deallocate(CharT* data,
+                    const std::size_t capacity) noexcept
+    {
+        AllocatorTraits::deallocate(allocator(), data, capacity + 1);
+    }
+
+    ///=============================================================================
+    /// @brief Capacity to grow to when at least required characters are needed:
+    ///        twice the current one, so that appends are amortized O(1).
+    ///=============================================================================
+    std::size_t grownCapacity(const std::size_t required) const noexcept
+    {
+        const std::size_t doubled = 2 * capacity();
+        return doubled > required ? doubled : required;
+    }
+
+    ///=============================================================================
+    /// @brief Releases the heap buffer, if any. The pointer is left dangling.
+    ///=============================================================================
+    void deallocate() noexcept
+    {
+        if (!isLocal())
+        {
+            deallocate(m_data, m_capacity);
+        }
+    }
+
+    ///=============================================================================
+    /// @brief Replaces the content. Reuses the current storage if it is large
+    ///        enough, so short strings are copied without an allocation.
+    ///=============================================================================
+    void assign(const CharT* data,
+                const std::size_t size)
+    {
+        if (size > capacity())
+        {
+            CharT* buffer = allocate(size);
+            deallocate();
+            m_data = buffer;
+            m_capacity = size;
+        }
+        std::memmove(m_data, data, size * sizeof(CharT));
+        m_size = size;
+        m_data[m_size] = CharT();
+    }
+
+    ///=============================================================================
+    /// @brief Takes over the content of str, which must not own anything else
+    ///        than its own storage. str is left empty and local.
+    ///=============================================================================
+    void steal(String& str) noexcept
+    {
+        if (str.isLocal())
+        {
+            std::memcpy(m_local, str.m_local, sizeof(m_local));
+        }
+        else
+        {
+            m_data = str.m_data;
+            m_capacity = str.m_capacity;
+        }
+        m_size = str.m_size;
+        str.m_data = str.m_local;
+        str.m_size = 0;
+        str.m_local[0] = CharT();
+    }
+
+    CharT*      m_data;                     // m_local or a heap buffer
     std::size_t m_size;
-    std::size_t m_capacity;
-    CharT*      m_data;
+    union
+    {
+        std::size_t m_capacity;             // of the heap buffer
+        CharT       m_local[LOCAL_CAPACITY + 1];
+    };
 };
 
 template class String<char>;
@@ -230,60 +914,68 @@ using WString = String<wchar_t>;
 
 ///=============================================================================
 ///=============================================================================
-template <typename CharT>
-inline bool operator==(const String<CharT>& lhs, const String<CharT>& rhs)
+template <typename CharT, typename Allocator>
+inline bool operator==(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs)
 {
-    return strncmp(lhs.c_str(), rhs.c_str()) == 0;
+    return lhs.equals(rhs);
 }
 
 ///=============================================================================
 ///=============================================================================
-template <typename CharT>
-inline bool operator!=(const String<CharT>& lhs, const String<CharT>& rhs)
+template <typename CharT, typename Allocator>
+inline bool operator!=(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs)
 {
-    return strncmp(lhs.c_str(), rhs.c_str()) != 0;
+    return !lhs.equals(rhs);
 }
 
 ///=============================================================================
 ///=============================================================================
-template <typename CharT>
-inline bool operator<(const String<CharT>& lhs, const String<CharT>& rhs)
+template <typename CharT, typename Allocator>
+inline bool operator<(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs)
 {
-    return strncmp(lhs.c_str(), rhs.c_str()) < 0;
+    return lhs.compare(rhs) < 0;
 }
 
 ///=============================================================================
 ///=============================================================================
-template <typename CharT>
-inline bool operator>(const String<CharT>& lhs, const String<CharT>& rhs)
+template <typename CharT, typename Allocator>
+inline bool operator>(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs)
 {
-    return strncmp(lhs.c_str(), rhs.c_str()) < 0;
+    return lhs.compare(rhs) > 0;
 }
 
 ///=============================================================================
 ///=============================================================================
-template <typename CharT>
-inline bool operator<=(const String<CharT>& lhs, const String<CharT>& rhs)
+template <typename CharT, typename Allocator>
+inline bool operator<=(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs)
 {
-    return strncmp(lhs.c_str(), rhs.c_str()) <= 0;
+    return lhs.compare(rhs) <= 0;
 }
 
 ///=============================================================================
 ///=============================================================================
-template <typename CharT>
-inline bool operator>=(const String<CharT>& lhs, const String<CharT>& rhs)
+template <typename CharT, typename Allocator>
+inline bool operator>=(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs)
 {
-    return strncmp(lhs.c_str(), rhs.c_str()) >= 0;
+    return lhs.compare(rhs) >= 0;
 }
 
 ///=============================================================================
+/// Hash of the characters (see StringHash.h), for unordered containers.
 ///=============================================================================
-template <typename CharT>
-inline String<CharT> operator+(const String<CharT>& lhs, const String<CharT>& rhs)
+namespace std
 {
-    lhs += rhs;
-    return lhs;
+    template <typename CharT, typename Allocator>
+    struct hash<String<CharT, Allocator>>
+    {
+        std::size_t operator()(const String<CharT, Allocator>& str) const
+        {
+            return StringKernels::hash(str.begin(), str.size());
+        }
+    };
 }
 
+#include "StringConcat.h"
+
 #endif // STRING_H
 
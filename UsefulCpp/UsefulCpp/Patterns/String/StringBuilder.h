@@ -0,0 +1,173 @@
+#ifndef STRINGBUILDER_H
+#define STRINGBUILDER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>    // for std::char_traits
+#include <vector>
+
+#include "String.h"
+
+///=============================================================================
+/// Collects pieces of a string and builds it at the end with a single
+/// allocation and a single copy of every piece, for strings assembled in
+/// loops, where an expression (see StringConcat.h) cannot be written.
+///
+/// append() of a String or of characters records a reference: the characters
+/// must stay alive and unchanged until build(). appendCopy() and single
+/// characters are copied into the builder, so temporaries are safe there.
+///
+/// Example of usage:
+/// CStringBuilder builder;
+/// for (const CString& column : columns)
+/// {
+///     builder.append(column).append(',');
+/// }
+/// CString row = builder.build();
+///=============================================================================
+template <typename CharT, typename Allocator = std::allocator<CharT>>
+class StringBuilder
+{
+public:
+    using StringType = String<CharT, Allocator>;
+
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const std::size_t pieces - number of pieces to reserve room for.
+    ///=============================================================================
+    explicit StringBuilder(const std::size_t pieces = 0)
+        : m_size(0)
+    {
+        m_pieces.reserve(pieces);
+    }
+
+    ///=============================================================================
+    /// @brief Appends a reference to size characters.
+    ///
+    /// @param const CharT* data - characters, alive until build().
+    /// @param const std::size_t size - number of characters.
+    ///
+    /// @return StringBuilder& - this builder.
+    ///=============================================================================
+    StringBuilder& append(const CharT* data,
+                          const std::size_t size)
+    {
+        if (size != 0)
+        {
+            m_pieces.push_back({ data, 0, size });
+            m_size += size;
+        }
+        return *this;
+    }
+
+    ///=============================================================================
+    /// @brief Appends a reference to a string.
+    ///=============================================================================
+    template <typename StringAllocator>
+    StringBuilder& append(const String<CharT, StringAllocator>& str)
+    {
+        return append(str.begin(), str.size());
+    }
+
+    ///=============================================================================
+    /// @brief Appends a reference to a c-string.
+    ///=============================================================================
+    StringBuilder& append(const CharT* cstr)
+    {
+        return append(cstr, std::char_traits<CharT>::length(cstr));
+    }
+
+    ///=============================================================================
+    /// @brief Appends a single character, copied.
+    ///=============================================================================
+    StringBuilder& append(const CharT c)
+    {
+        return appendCopy(&c, 1);
+    }
+
+    ///=============================================================================
+    /// @brief Appends a copy of size characters.
+    ///
+    /// @param const CharT* data - characters, may die right after the call.
+    /// @param const std::size_t size - number of characters.
+    ///
+    /// @return StringBuilder& - this builder.
+    ///=============================================================================
+    StringBuilder& appendCopy(const CharT* data,
+                              const std::size_t size)
+    {
+        if (size == 0)
+        {
+            return *this;
+        }
+        // Consecutive copies extend a single piece
+        if (!m_pieces.empty() && m_pieces.back().data == nullptr &&
+            m_pieces.back().offset + m_pieces.back().size == m_copies.size())
+        {
+            m_pieces.back().size += size;
+        }
+        else
+        {
+            m_pieces.push_back({ nullptr, m_copies.size(), size });
+        }
+        m_copies.insert(m_copies.end(), data, data + size);
+        m_size += size;
+        return *this;
+    }
+
+    ///=============================================================================
+    /// @brief Gets the number of characters appended so far.
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_size; }
+
+    ///=============================================================================
+    /// @brief Builds the string: one allocation of size() characters, every
+    ///        piece is copied once. The builder keeps its pieces.
+    ///
+    /// @param const Allocator& allocator - allocator of the string.
+    ///
+    /// @return StringType - the string.
+    ///=============================================================================
+    StringType build(const Allocator& allocator = Allocator()) const
+    {
+        StringType str(allocator);
+        str.reserve(m_size);
+        for (const Piece& piece : m_pieces)
+        {
+            str.append(piece.data != nullptr ? piece.data : m_copies.data() + piece.offset, piece.size);
+        }
+        return str;
+    }
+
+    ///=============================================================================
+    /// @brief Removes all the pieces. The memory is kept for reuse.
+    ///
+    /// @return void.
+    ///=============================================================================
+    void clear() noexcept
+    {
+        m_pieces.clear();
+        m_copies.clear();
+        m_size = 0;
+    }
+
+private:
+    // A reference to caller characters, or copied ones (data is null) at
+    // offset in m_copies, which moves as it grows
+    struct Piece
+    {
+        const CharT* data;
+        std::size_t  offset;
+        std::size_t  size;
+    };
+
+    std::vector<Piece> m_pieces;
+    std::vector<CharT> m_copies;
+    std::size_t        m_size;
+};
+
+using CStringBuilder = StringBuilder<char>;
+using WStringBuilder = StringBuilder<wchar_t>;
+
+#endif // STRINGBUILDER_H
@@ -0,0 +1,287 @@
+#ifndef STRINGCONCAT_H
+#define STRINGCONCAT_H
+
+#include <cstddef>
+#include <string>    // for std::char_traits
+
+#include "String.h"
+
+///=============================================================================
+/// Lazy concatenation (expression templates). a + b + c + d does not create a
+/// String per step: it builds a small StringConcat tree which only refers to
+/// the pieces. When the tree is turned into a String (construction, assignment
+/// or +=), the total length is summed first, the buffer is allocated once and
+/// every piece is copied into it once.
+///
+/// The expression refers to the strings it was built from, so it must be used
+/// within their lifetime, like a pointer. Storing it with auto keeps the
+/// expression, not a String:
+/// CString path = directory + '/' + name + ".txt";   // one allocation
+/// auto lazy = directory + '/' + name;              // no String yet
+///=============================================================================
+
+///=============================================================================
+/// Leaf of an expression: characters owned by somebody else.
+///=============================================================================
+template <typename CharT>
+class ConcatPiece
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const CharT* data - characters.
+    /// @param const std::size_t size - number of characters.
+    ///=============================================================================
+    ConcatPiece(const CharT* data,
+                const std::size_t size) noexcept
+        : m_data(data)
+        , m_size(size)
+    {}
+
+    ///=============================================================================
+    /// @brief Gets the number of characters.
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_size; }
+
+    ///=============================================================================
+    /// @brief Copies the characters to out.
+    ///
+    /// @return CharT* - end of the copied characters.
+    ///=============================================================================
+    CharT* copyTo(CharT* out) const noexcept
+    {
+        std::char_traits<CharT>::copy(out, m_data, m_size);
+        return out + m_size;
+    }
+
+private:
+    const CharT* m_data;
+    std::size_t  m_size;
+};
+
+///=============================================================================
+/// Leaf of an expression: a single character, kept by value.
+///=============================================================================
+template <typename CharT>
+class ConcatChar
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const CharT c - character.
+    ///=============================================================================
+    explicit ConcatChar(const CharT c) noexcept
+        : m_char(c)
+    {}
+
+    ///=============================================================================
+    /// @brief Gets the number of characters.
+    ///=============================================================================
+    std::size_t size() const noexcept { return 1; }
+
+    ///=============================================================================
+    /// @brief Copies the character to out.
+    ///
+    /// @return CharT* - end of the copied character.
+    ///=============================================================================
+    CharT* copyTo(CharT* out) const noexcept
+    {
+        *out = m_char;
+        return out + 1;
+    }
+
+private:
+    CharT m_char;
+};
+
+///=============================================================================
+/// Concatenation of two sub-expressions, which are leaves or other
+/// concatenations, kept by value. StringT is the String type the expression
+/// turns into.
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+class StringConcat
+{
+public:
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const Lhs& lhs - left part.
+    /// @param const Rhs& rhs - right part.
+    ///=============================================================================
+    StringConcat(const Lhs& lhs,
+                 const Rhs& rhs) noexcept
+        : m_lhs(lhs)
+        , m_rhs(rhs)
+    {}
+
+    ///=============================================================================
+    /// @brief Gets the total number of characters.
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_lhs.size() + m_rhs.size(); }
+
+    ///=============================================================================
+    /// @brief Copies all the pieces to out, left to right.
+    ///
+    /// @return CharT* - end of the copied characters.
+    ///=============================================================================
+    template <typename CharT>
+    CharT* copyTo(CharT* out) const noexcept
+    {
+        return m_rhs.copyTo(m_lhs.copyTo(out));
+    }
+
+    ///=============================================================================
+    /// @brief Materializes the expression.
+    ///
+    /// @return StringT - the concatenated string.
+    ///=============================================================================
+    StringT str() const
+    {
+        return StringT(*this);
+    }
+
+private:
+    Lhs m_lhs;
+    Rhs m_rhs;
+};
+
+//======================== Operands ============================================
+
+///=============================================================================
+/// @brief Wraps a string operand of + into a leaf.
+///=============================================================================
+template <typename CharT, typename Allocator>
+inline ConcatPiece<CharT> concatOperand(const String<CharT, Allocator>& str) noexcept
+{
+    return ConcatPiece<CharT>(str.begin(), str.size());
+}
+
+template <typename CharT>
+inline ConcatPiece<CharT> concatOperand(const CharT* cstr) noexcept
+{
+    return ConcatPiece<CharT>(cstr, std::char_traits<CharT>::length(cstr));
+}
+
+///=============================================================================
+/// @brief Builds the expression node of lhs + rhs.
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, Lhs, Rhs> makeConcat(const Lhs& lhs, const Rhs& rhs) noexcept
+{
+    return StringConcat<StringT, Lhs, Rhs>(lhs, rhs);
+}
+
+//======================== Concatenation operators =============================
+
+///=============================================================================
+///=============================================================================
+template <typename CharT, typename Allocator>
+inline StringConcat<String<CharT, Allocator>, ConcatPiece<CharT>, ConcatPiece<CharT>>
+operator+(const String<CharT, Allocator>& lhs, const String<CharT, Allocator>& rhs) noexcept
+{
+    return makeConcat<String<CharT, Allocator>>(concatOperand(lhs), concatOperand(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename CharT, typename Allocator>
+inline StringConcat<String<CharT, Allocator>, ConcatPiece<CharT>, ConcatPiece<CharT>>
+operator+(const String<CharT, Allocator>& lhs, const CharT* rhs) noexcept
+{
+    return makeConcat<String<CharT, Allocator>>(concatOperand(lhs), concatOperand(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename CharT, typename Allocator>
+inline StringConcat<String<CharT, Allocator>, ConcatPiece<CharT>, ConcatPiece<CharT>>
+operator+(const CharT* lhs, const String<CharT, Allocator>& rhs) noexcept
+{
+    return makeConcat<String<CharT, Allocator>>(concatOperand(lhs), concatOperand(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename CharT, typename Allocator>
+inline StringConcat<String<CharT, Allocator>, ConcatPiece<CharT>, ConcatChar<CharT>>
+operator+(const String<CharT, Allocator>& lhs, const CharT rhs) noexcept
+{
+    return makeConcat<String<CharT, Allocator>>(concatOperand(lhs), ConcatChar<CharT>(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename CharT, typename Allocator>
+inline StringConcat<String<CharT, Allocator>, ConcatChar<CharT>, ConcatPiece<CharT>>
+operator+(const CharT lhs, const String<CharT, Allocator>& rhs) noexcept
+{
+    return makeConcat<String<CharT, Allocator>>(ConcatChar<CharT>(lhs), concatOperand(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, StringConcat<StringT, Lhs, Rhs>, ConcatPiece<typename StringT::value_type>>
+operator+(const StringConcat<StringT, Lhs, Rhs>& lhs, const StringT& rhs) noexcept
+{
+    return makeConcat<StringT>(lhs, concatOperand(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, ConcatPiece<typename StringT::value_type>, StringConcat<StringT, Lhs, Rhs>>
+operator+(const StringT& lhs, const StringConcat<StringT, Lhs, Rhs>& rhs) noexcept
+{
+    return makeConcat<StringT>(concatOperand(lhs), rhs);
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, StringConcat<StringT, Lhs, Rhs>, ConcatPiece<typename StringT::value_type>>
+operator+(const StringConcat<StringT, Lhs, Rhs>& lhs, const typename StringT::value_type* rhs) noexcept
+{
+    return makeConcat<StringT>(lhs, concatOperand(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, ConcatPiece<typename StringT::value_type>, StringConcat<StringT, Lhs, Rhs>>
+operator+(const typename StringT::value_type* lhs, const StringConcat<StringT, Lhs, Rhs>& rhs) noexcept
+{
+    return makeConcat<StringT>(concatOperand(lhs), rhs);
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, StringConcat<StringT, Lhs, Rhs>, ConcatChar<typename StringT::value_type>>
+operator+(const StringConcat<StringT, Lhs, Rhs>& lhs, const typename StringT::value_type rhs) noexcept
+{
+    return makeConcat<StringT>(lhs, ConcatChar<typename StringT::value_type>(rhs));
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs, typename Rhs>
+inline StringConcat<StringT, ConcatChar<typename StringT::value_type>, StringConcat<StringT, Lhs, Rhs>>
+operator+(const typename StringT::value_type lhs, const StringConcat<StringT, Lhs, Rhs>& rhs) noexcept
+{
+    return makeConcat<StringT>(ConcatChar<typename StringT::value_type>(lhs), rhs);
+}
+
+///=============================================================================
+///=============================================================================
+template <typename StringT, typename Lhs1, typename Rhs1, typename Lhs2, typename Rhs2>
+inline StringConcat<StringT, StringConcat<StringT, Lhs1, Rhs1>, StringConcat<StringT, Lhs2, Rhs2>>
+operator+(const StringConcat<StringT, Lhs1, Rhs1>& lhs, const StringConcat<StringT, Lhs2, Rhs2>& rhs) noexcept
+{
+    return makeConcat<StringT>(lhs, rhs);
+}
+
+#endif // STRINGCONCAT_H
@@ -0,0 +1,485 @@
+#ifndef STRINGFORMAT_H
+#define STRINGFORMAT_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include "String.h"
+
+///=============================================================================
+/// Numbers to text and back without streams, locales nor temporaries, in the
+/// manner of std::to_chars / std::from_chars:
+///
+/// - appendNumber() formats an integer or a floating-point value right into
+///   the capacity of a String;
+/// - appendNumbers() formats a whole array of integers with a separator, the
+///   string grows once per chunk of values;
+/// - parseNumber() reads a number which is the whole of a String or view, and
+///   throws like std::stoi on invalid or out of range text;
+/// - StringKernels::toChars / fromChars are the underlying kernels, on raw
+///   buffers and without exceptions.
+///
+/// Integers are written by a kernel of their own (8 digits at a time in the
+/// bytes of a 64-bit word), for char and wchar_t alike.
+/// Floating-point values go through std::to_chars / std::from_chars: the
+/// shortest text which reads back to the same value, or the given format and
+/// precision. Floating-point parsing is for char text only.
+///
+/// Example of usage:
+/// CString line;
+/// appendNumber(line, count);
+/// line += ' ';
+/// appendNumber(line, ratio, std::chars_format::fixed, 3);
+/// appendNumbers(keys.data(), keys.size(), csv, ',');
+/// const std::uint32_t port = parseNumber<std::uint32_t>(portText);
+///=============================================================================
+namespace StringKernels
+{
+    // Most characters an integer of up to 64 bits is written with
+    constexpr std::size_t MAX_INTEGER_CHARS = 20;
+
+    // Most characters of the shortest form of a float, a double or an x87
+    // long double
+    constexpr std::size_t MAX_FLOAT_CHARS = 32;
+
+    ///=============================================================================
+    /// @brief Number of decimal digits of value, from its bit length.
+    ///=============================================================================
+    inline unsigned decimalDigits(const std::uint64_t value) noexcept
+    {
+        static constexpr std::uint64_t POWERS_OF_10[20] =
+        {
+            1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+            100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+            10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+            100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+        };
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long highest;
+        _BitScanReverse64(&highest, value | 1);
+        const unsigned bits = static_cast<unsigned>(highest) + 1;
+#elif defined(_MSC_VER)
+        unsigned bits = 0;
+        for (std::uint64_t rest = value | 1; rest != 0; rest >>= 1)
+        {
+            ++bits;
+        }
+#else
+        const unsigned bits = 64 - static_cast<unsigned>(__builtin_clzll(value | 1));
+#endif
+        // 1233 / 4096 is just above log10(2): the count is guess or guess + 1.
+        // value | 1 gives 0 a digit, and is below the same powers as value.
+        const unsigned guess = (bits * 1233) >> 12;
+        return guess + 1 - ((value | 1) < POWERS_OF_10[guess] ? 1 : 0);
+    }
+
+    ///=============================================================================
+    /// @brief The 8 decimal digits of value < 10^8, as ASCII bytes from the
+    ///        lowest one, most significant digit first. Every step splits all
+    ///        the groups of the word at once: 4 + 4 digits, then 2 + 2, 1 + 1,
+    ///        dividing by 100 and 10 with multiplications.
+    ///=============================================================================
+    inline std::uint64_t packDigits8(const std::uint32_t value) noexcept
+    {
+        const std::uint64_t groups4 = (value / 10000) | (static_cast<std::uint64_t>(value % 10000) << 32);
+        const std::uint64_t high2 = ((groups4 * 10486) >> 20) & 0x0000007F0000007Full;
+        const std::uint64_t groups2 = high2 | ((groups4 - high2 * 100) << 16);
+        const std::uint64_t high1 = ((groups2 * 103) >> 10) & 0x000F000F000F000Full;
+        const std::uint64_t digits = high1 | ((groups2 - high1 * 10) << 8);
+        return digits + 0x3030303030303030ull;
+    }
+
+    ///=============================================================================
+    /// @brief Writes the last count (1 to 8) of the 8 digits of value < 10^8.
+    ///        Always stores 8 characters, in a single store for char.
+    ///
+    /// @return CharT* - end of the count digits.
+    ///=============================================================================
+    template <typename CharT>
+    inline CharT* writeDigits8(CharT* out,
+                               const std::uint32_t value,
+                               const unsigned count) noexcept
+    {
+        const std::uint64_t digits = packDigits8(value) >> (8 * (8 - count));
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            out[i] = static_cast<CharT>(static_cast<unsigned char>(digits >> (8 * i)));
+        }
+        return out + count;
+    }
+
+    inline char* writeDigits8(char* out,
+                              const std::uint32_t value,
+                              const unsigned count) noexcept
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        const std::uint64_t digits = packDigits8(value) >> (8 * (8 - count));
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            out[i] = static_cast<char>(digits >> (8 * i));
+        }
+#else
+        // Compilers do not always merge the byte stores of the loop above
+        const std::uint64_t digits = packDigits8(value) >> (8 * (8 - count));
+        std::memcpy(out, &digits, sizeof(digits));
+#endif
+        return out + count;
+    }
+
+    ///=============================================================================
+    /// @brief Writes the digits of an unsigned value, by groups of 8. Up to
+    ///        7 characters past the end may be overwritten.
+    ///
+    /// @return CharT* - end of the digits.
+    ///=============================================================================
+    template <typename CharT>
+    inline CharT* formatUnsigned(CharT* out,
+                                 const std::uint32_t value) noexcept
+    {
+        if (value < 100000000u)
+        {
+            return writeDigits8(out, value, decimalDigits(value));
+        }
+        const std::uint32_t high = value / 100000000u;
+        out = writeDigits8(out, high, decimalDigits(high));
+        return writeDigits8(out, value % 100000000u, 8);
+    }
+
+    template <typename CharT>
+    inline CharT* formatUnsigned(CharT* out,
+                                 const std::uint64_t value) noexcept
+    {
+        if (value <= 0xFFFFFFFFull)
+        {
+            return formatUnsigned(out, static_cast<std::uint32_t>(value));
+        }
+        const std::uint64_t low = value % 100000000u;
+        std::uint64_t high = value / 100000000u;
+        if (high >= 100000000u)
+        {
+            const std::uint32_t top = static_cast<std::uint32_t>(high / 100000000u);
+            out = writeDigits8(out, top, decimalDigits(top));
+            high %= 100000000u;
+            out = writeDigits8(out, static_cast<std::uint32_t>(high), 8);
+        }
+        else
+        {
+            out = writeDigits8(out, static_cast<std::uint32_t>(high), decimalDigits(high));
+        }
+        return writeDigits8(out, static_cast<std::uint32_t>(low), 8);
+    }
+
+    ///=============================================================================
+    /// @brief Writes an integer in decimal. out must have room for
+    ///        MAX_INTEGER_CHARS characters, which may all be overwritten.
+    ///
+    /// @param CharT* out - destination.
+    /// @param const Int value - integer.
+    ///
+    /// @return CharT* - end of the written characters.
+    ///=============================================================================
+    template <typename CharT, typename Int,
+              typename = typename std::enable_if<std::is_integral<Int>::value>::type>
+    inline CharT* toChars(CharT* out,
+                          const Int value) noexcept
+    {
+        static_assert(!std::is_same<Int, bool>::value, "toChars: bool is not a number");
+        static_assert(sizeof(Int) <= 8, "toChars: integers of up to 64 bits only");
+        // 32-bit arithmetic is faster for the values which fit it
+        using UInt = typename std::conditional<sizeof(Int) <= 4, std::uint32_t, std::uint64_t>::type;
+        UInt magnitude = static_cast<UInt>(value);
+        if (std::is_signed<Int>::value && value < 0)
+        {
+            *out++ = static_cast<CharT>('-');
+            magnitude = static_cast<UInt>(0) - magnitude;
+        }
+        return formatUnsigned(out, magnitude);
+    }
+
+    ///=============================================================================
+    /// @brief Copies ASCII chars to wider characters, from the last one, so that
+    ///        the chars may lie at the start of the destination buffer.
+    ///
+    /// @return CharT* - end of the written characters.
+    ///=============================================================================
+    template <typename CharT>
+    inline CharT* widenBackwards(const char* first,
+                                 const char* last,
+                                 CharT* out) noexcept
+    {
+        CharT* const end = out + (last - first);
+        for (CharT* p = end; last != first; )
+        {
+            *--p = static_cast<CharT>(*--last);
+        }
+        return end;
+    }
+
+    ///=============================================================================
+    /// @brief Writes the shortest text which reads back to value. out must have
+    ///        room for MAX_FLOAT_CHARS characters.
+    ///
+    /// @return CharT* - end of the written characters.
+    ///=============================================================================
+    template <typename CharT, typename Float,
+              typename = typename std::enable_if<std::is_floating_point<Float>::value>::type,
+              typename = void>
+    inline CharT* toChars(CharT* out,
+                          const Float value) noexcept
+    {
+        // Sign, digits, point and exponent ("e-4951") of the shortest form
+        static_assert(std::numeric_limits<Float>::max_digits10 + 8 <= MAX_FLOAT_CHARS,
+                      "toChars: the shortest form of Float may not fit MAX_FLOAT_CHARS");
+        char buffer[MAX_FLOAT_CHARS];
+        const std::to_chars_result result = std::to_chars(buffer, buffer + MAX_FLOAT_CHARS, value);
+        return widenBackwards(buffer, result.ptr, out);
+    }
+
+    inline char* toChars(char* out,
+                         const double value) noexcept
+    {
+        return std::to_chars(out, out + MAX_FLOAT_CHARS, value).ptr;
+    }
+
+    ///=============================================================================
+    /// @brief Most characters of a value of type Float written with a precision,
+    ///        in any format. The integer digits of a fixed max() lead (309 for
+    ///        a double, 4933 for an x87 long double), then a sign, a point, the
+    ///        precision digits and at most 8 characters of exponent ("p-16445").
+    ///=============================================================================
+    template <typename Float>
+    inline std::size_t maxFloatChars(const int precision) noexcept
+    {
+        return static_cast<std::size_t>(std::numeric_limits<Float>::max_exponent10) + 11
+            + static_cast<std::size_t>(precision > 0 ? precision : 0);
+    }
+
+    ///=============================================================================
+    /// Outcome of fromChars, like std::from_chars_result: ptr is the end of the
+    /// number, or first if ec is std::errc::invalid_argument.
+    ///=============================================================================
+    template <typename CharT>
+    struct ParseResult
+    {
+        const CharT* ptr;
+        std::errc    ec;
+    };
+
+    ///=============================================================================
+    /// @brief Reads a decimal integer at the start of [first, last), with a '-'
+    ///        for signed types, without leading '+' nor spaces.
+    ///
+    /// @param const CharT* first - start of the text.
+    /// @param const CharT* last - end of the text.
+    /// @param Int& value - receives the value, unchanged on failure.
+    ///
+    /// @return ParseResult<CharT> - end of the number and error code.
+    ///=============================================================================
+    template <typename CharT, typename Int,
+              typename = typename std::enable_if<std::is_integral<Int>::value>::type>
+    ParseResult<CharT> fromChars(const CharT* first,
+                                 const CharT* last,
+                                 Int& value) noexcept
+    {
+        static_assert(!std::is_same<Int, bool>::value, "fromChars: bool is not a number");
+        using UInt = typename std::make_unsigned<Int>::type;
+        const CharT* p = first;
+        const bool negative = std::is_signed<Int>::value && p != last && *p == static_cast<CharT>('-');
+        if (negative)
+        {
+            ++p;
+        }
+        // Largest magnitude: one more for the negative values of signed types
+        const UInt limit = static_cast<UInt>(std::numeric_limits<Int>::max()) + (negative ? 1u : 0u);
+
+        const CharT* const digits = p;
+        UInt magnitude = 0;
+        bool overflow = false;
+        for (; p != last; ++p)
+        {
+            const unsigned digit = static_cast<unsigned>(charCode(*p)) - '0';
+            if (digit > 9)
+            {
+                break;
+            }
+            if (magnitude > (limit - digit) / 10)
+            {
+                overflow = true;
+            }
+            else
+            {
+                magnitude = static_cast<UInt>(magnitude * 10 + digit);
+            }
+        }
+        if (p == digits)
+        {
+            return { first, std::errc::invalid_argument };
+        }
+        if (overflow)
+        {
+            return { p, std::errc::result_out_of_range };
+        }
+        value = negative ? static_cast<Int>(static_cast<UInt>(0) - magnitude) : static_cast<Int>(magnitude);
+        return { p, std::errc() };
+    }
+
+    ///=============================================================================
+    /// @brief Reads a floating-point number at the start of [first, last), as
+    ///        std::from_chars in the general format.
+    ///=============================================================================
+    template <typename Float,
+              typename = typename std::enable_if<std::is_floating_point<Float>::value>::type,
+              typename = void>
+    ParseResult<char> fromChars(const char* first,
+                                const char* last,
+                                Float& value) noexcept
+    {
+        const std::from_chars_result result = std::from_chars(first, last, value);
+        return { result.ptr, result.ec };
+    }
+}
+
+///=============================================================================
+/// @brief Appends an integer or the shortest round-trip text of a
+///        floating-point value, written in place in the capacity of str.
+///
+/// @param String<CharT, Allocator>& str - destination.
+/// @param const T value - number.
+///
+/// @return String<CharT, Allocator>& - str.
+///=============================================================================
+template <typename CharT, typename Allocator, typename T,
+          typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+String<CharT, Allocator>& appendNumber(String<CharT, Allocator>& str,
+                                       const T value)
+{
+    const std::size_t size = str.size();
+    const std::size_t room = std::is_integral<T>::value ? StringKernels::MAX_INTEGER_CHARS : StringKernels::MAX_FLOAT_CHARS;
+    str.resize_and_overwrite(size + room, [size, value](CharT* data, std::size_t)
+    {
+        return static_cast<std::size_t>(StringKernels::toChars(data + size, value) - data);
+    });
+    return str;
+}
+
+///=============================================================================
+/// @brief Appends a floating-point value in the given format and precision,
+///        as std::to_chars does.
+///
+/// @param String<CharT, Allocator>& str - destination.
+/// @param const Float value - number.
+/// @param const std::chars_format format - fixed, scientific, general or hex.
+/// @param const int precision - digits after the point (significant digits
+///        for general).
+///
+/// @throw std::length_error - std::to_chars could not write the value; str
+///        is left unchanged.
+///
+/// @return String<CharT, Allocator>& - str.
+///=============================================================================
+template <typename CharT, typename Allocator, typename Float,
+          typename = typename std::enable_if<std::is_floating_point<Float>::value>::type>
+String<CharT, Allocator>& appendNumber(String<CharT, Allocator>& str,
+                                       const Float value,
+                                       const std::chars_format format,
+                                       const int precision)
+{
+    const std::size_t size = str.size();
+    const std::size_t room = StringKernels::maxFloatChars<Float>(precision);
+    bool written = false;
+    str.resize_and_overwrite(size + room, [size, value, format, precision, room, &written](CharT* data, std::size_t)
+    {
+        // The chars are written at the start of the room and widened in place
+        CharT* const out = data + size;
+        char* const chars = reinterpret_cast<char*>(out);
+        const std::to_chars_result result = std::to_chars(chars, chars + room, value, format, precision);
+        written = result.ec == std::errc();
+        return written ? static_cast<std::size_t>(StringKernels::widenBackwards(chars, result.ptr, out) - data) : size;
+    });
+    if (!written)
+    {
+        throw std::length_error("appendNumber: value does not fit its maximum length");
+    }
+    return str;
+}
+
+///=============================================================================
+/// @brief Appends count integers, with separator between them. The string
+///        grows once per chunk of values, every value is written in place.
+///
+/// @param const Int* values - integers.
+/// @param const std::size_t count - number of integers.
+/// @param String<CharT, Allocator>& str - destination.
+/// @param const CharT separator - character between two values.
+///
+/// @return String<CharT, Allocator>& - str.
+///=============================================================================
+template <typename Int, typename CharT, typename Allocator,
+          typename = typename std::enable_if<std::is_integral<Int>::value>::type>
+String<CharT, Allocator>& appendNumbers(const Int* values,
+                                        const std::size_t count,
+                                        String<CharT, Allocator>& str,
+                                        const CharT separator = CharT(' '))
+{
+    // Bounds the unused room of a chunk to a few pages
+    const std::size_t CHUNK = 1024;
+    for (std::size_t first = 0; first < count; first += CHUNK)
+    {
+        const std::size_t last = count - first < CHUNK ? count : first + CHUNK;
+        const std::size_t size = str.size();
+        str.resize_and_overwrite(size + (last - first) * (StringKernels::MAX_INTEGER_CHARS + 1),
+                                 [size, values, first, last, separator](CharT* data, std::size_t)
+        {
+            CharT* out = data + size;
+            for (std::size_t i = first; i < last; ++i)
+            {
+                if (i != 0)
+                {
+                    *out++ = separator;
+                }
+                out = StringKernels::toChars(out, values[i]);
+            }
+            return static_cast<std::size_t>(out - data);
+        });
+    }
+    return str;
+}
+
+///=============================================================================
+/// @brief Reads a number which makes the whole text: no spaces, no leading
+///        '+', nothing after it.
+///
+/// @param const BasicStringView<CharT> text - the number.
+///
+/// @return T - the value.
+///=============================================================================
+template <typename T, typename CharT>
+T parseNumber(const BasicStringView<CharT> text)
+{
+    T value = T();
+    const StringKernels::ParseResult<CharT> result = StringKernels::fromChars(text.begin(), text.end(), value);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        throw std::out_of_range("parseNumber: value out of range");
+    }
+    if (result.ec != std::errc() || result.ptr != text.end())
+    {
+        throw std::invalid_argument("parseNumber: not a number");
+    }
+    return value;
+}
+
+template <typename T, typename CharT, typename Allocator>
+T parseNumber(const String<CharT, Allocator>& str)
+{
+    return parseNumber<T>(str.view());
+}
+
+#endif // STRINGFORMAT_H
@@ -0,0 +1,396 @@
+#ifndef STRINGHASH_H
+#define STRINGHASH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "..\..\Platform\CpuFeatures.h"
+
+///=============================================================================
+/// Fast non-cryptographic 64-bit hash of bytes, in the wyhash / XXH3 family.
+/// It is not compatible with either of them, and is meant for hash tables of
+/// one process: it must not be persisted nor used against adversarial keys.
+///
+/// - up to LONG_HASH_THRESHOLD bytes: wyhash-style, 16 bytes per 64x64->128
+///   bit multiply, with three independent lanes over long enough inputs;
+/// - longer inputs: XXH3-style, eight 64-bit accumulators updated with a
+///   64-byte stripe at a time (32x32->64 bit multiplies, which map onto
+///   SSE2 / AVX2), scrambled every block of STRIPES_PER_BLOCK stripes, and
+///   folded with the wyhash mixer at the end.
+///
+/// The scalar, SSE2 and AVX2 paths give the same result.
+///
+/// Example of usage:
+/// std::uint64_t h = StringKernels::hashBytes(buffer.data(), buffer.size());
+/// std::unordered_map<CString, int> counters;     // uses std::hash<CString>
+///=============================================================================
+namespace StringKernels
+{
+    // Inputs longer than that take the accumulator path
+    constexpr std::size_t LONG_HASH_THRESHOLD = 256;
+
+    // Bytes of input per accumulator update
+    constexpr std::size_t HASH_STRIPE_SIZE = 64;
+
+    // Stripes between two scrambles of the accumulators
+    constexpr std::size_t STRIPES_PER_BLOCK = 16;
+
+    // Mixing constants of wyhash
+    constexpr std::uint64_t WY_SECRET[4] =
+    {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+
+    constexpr std::uint64_t PRIME32_1 = 0x9E3779B1ull;
+
+    ///=============================================================================
+    /// @brief Pseudo-random words (splitmix64) for the keys of the accumulator
+    ///        path: STRIPES_PER_BLOCK words step through them, eight for the
+    ///        scramble and eight for the last stripe follow.
+    ///=============================================================================
+    constexpr std::array<std::uint64_t, 40> makeHashKeys()
+    {
+        std::array<std::uint64_t, 40> keys = {};
+        std::uint64_t state = 0x60bee2bee120fc15ull;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            state += 0x9e3779b97f4a7c15ull;
+            std::uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            keys[i] = z ^ (z >> 31);
+        }
+        return keys;
+    }
+
+    // Stripe keys take words [n, n + 8) for the n-th stripe of a block
+    constexpr std::size_t SCRAMBLE_KEY = STRIPES_PER_BLOCK + 8;   // 8 words
+    constexpr std::size_t LAST_STRIPE_KEY = SCRAMBLE_KEY + 8;     // 8 words
+
+    struct HashKeys
+    {
+        static const std::array<std::uint64_t, 40>& words()
+        {
+            static constexpr std::array<std::uint64_t, 40> KEYS = makeHashKeys();
+            return KEYS;
+        }
+    };
+
+    ///=============================================================================
+    /// @brief Unaligned little-endian reads.
+    ///=============================================================================
+    inline std::uint64_t read64(const unsigned char* p) noexcept
+    {
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline std::uint64_t read32(const unsigned char* p) noexcept
+    {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    ///=============================================================================
+    /// @brief Full 64x64->128 bit product: a gets the low half, b the high one.
+    ///=============================================================================
+    inline void multiply128(std::uint64_t& a,
+                            std::uint64_t& b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        a = static_cast<std::uint64_t>(product);
+        b = static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        const std::uint64_t aLow = a & 0xFFFFFFFFull;
+        const std::uint64_t aHigh = a >> 32;
+        const std::uint64_t bLow = b & 0xFFFFFFFFull;
+        const std::uint64_t bHigh = b >> 32;
+        const std::uint64_t lowLow = aLow * bLow;
+        const std::uint64_t lowHigh = aLow * bHigh;
+        const std::uint64_t highLow = aHigh * bLow;
+        const std::uint64_t highHigh = aHigh * bHigh;
+        const std::uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFull) + (highLow & 0xFFFFFFFFull);
+        a = (middle << 32) | (lowLow & 0xFFFFFFFFull);
+        b = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Folds the 128-bit product of a and b into 64 bits.
+    ///=============================================================================
+    inline std::uint64_t mix64(std::uint64_t a,
+                               std::uint64_t b) noexcept
+    {
+        multiply128(a, b);
+        return a ^ b;
+    }
+
+    //=========================== Accumulator path =================================
+
+    /// Scalar update of the accumulators, the reference of the vector ones.
+    struct ScalarHashLanes
+    {
+        static void accumulate(std::uint64_t* acc,
+                               const unsigned char* stripe,
+                               const std::uint64_t* key)
+        {
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                const std::uint64_t data = read64(stripe + 8 * i);
+                const std::uint64_t mixed = data ^ key[i];
+                acc[i ^ 1] += data;
+                acc[i] += (mixed & 0xFFFFFFFFull) * (mixed >> 32);
+            }
+        }
+
+        static void scramble(std::uint64_t* acc,
+                             const std::uint64_t* key)
+        {
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                acc[i] = ((acc[i] ^ (acc[i] >> 47)) ^ key[i]) * PRIME32_1;
+            }
+        }
+    };
+
+#if defined(USEFULCPP_SSE2)
+    /// SSE2: four registers of two accumulators.
+    struct Sse2HashLanes
+    {
+        static void accumulate(std::uint64_t* acc,
+                               const unsigned char* stripe,
+                               const std::uint64_t* key)
+        {
+            __m128i* accumulators = reinterpret_cast<__m128i*>(acc);
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe) + i);
+                const __m128i mixed = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + i));
+                const __m128i product = _mm_mul_epu32(mixed, _mm_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                __m128i sum = _mm_add_epi64(_mm_loadu_si128(accumulators + i), swapped);
+                _mm_storeu_si128(accumulators + i, _mm_add_epi64(sum, product));
+            }
+        }
+
+        static void scramble(std::uint64_t* acc,
+                             const std::uint64_t* key)
+        {
+            __m128i* accumulators = reinterpret_cast<__m128i*>(acc);
+            const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                __m128i value = _mm_loadu_si128(accumulators + i);
+                value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+                value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + i));
+                const __m128i low = _mm_mul_epu32(value, prime);
+                const __m128i high = _mm_mul_epu32(_mm_srli_epi64(value, 32), prime);
+                _mm_storeu_si128(accumulators + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+            }
+        }
+    };
+#endif // USEFULCPP_SSE2
+
+#if defined(USEFULCPP_X86)
+    /// AVX2: two registers of four accumulators.
+    struct Avx2HashLanes
+    {
+        USEFULCPP_TARGET_AVX2 static void accumulate(std::uint64_t* acc,
+                                                     const unsigned char* stripe,
+                                                     const std::uint64_t* key)
+        {
+            __m256i* accumulators = reinterpret_cast<__m256i*>(acc);
+            for (std::size_t i = 0; i < 2; ++i)
+            {
+                const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe) + i);
+                const __m256i mixed = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + i));
+                const __m256i product = _mm256_mul_epu32(mixed, _mm256_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                const __m256i sum = _mm256_add_epi64(_mm256_loadu_si256(accumulators + i), swapped);
+                _mm256_storeu_si256(accumulators + i, _mm256_add_epi64(sum, product));
+            }
+        }
+
+        USEFULCPP_TARGET_AVX2 static void scramble(std::uint64_t* acc,
+                                                   const std::uint64_t* key)
+        {
+            __m256i* accumulators = reinterpret_cast<__m256i*>(acc);
+            const __m256i prime = _mm256_set1_epi32(static_cast<int>(PRIME32_1));
+            for (std::size_t i = 0; i < 2; ++i)
+            {
+                __m256i value = _mm256_loadu_si256(accumulators + i);
+                value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+                value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + i));
+                const __m256i low = _mm256_mul_epu32(value, prime);
+                const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+                _mm256_storeu_si256(accumulators + i, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+            }
+        }
+    };
+#endif // USEFULCPP_X86
+
+    ///=============================================================================
+    /// @brief Accumulator hash of more than HASH_STRIPE_SIZE bytes.
+    ///=============================================================================
+    template <typename Lanes>
+    std::uint64_t hashLongKernel(const unsigned char* p,
+                                 const std::size_t size,
+                                 const std::uint64_t seed)
+    {
+        const std::uint64_t* keys = HashKeys::words().data();
+        std::uint64_t acc[8] =
+        {
+            PRIME32_1, WY_SECRET[0], WY_SECRET[1], WY_SECRET[2],
+            WY_SECRET[3], seed ^ WY_SECRET[0], seed ^ WY_SECRET[1], PRIME32_1 ^ seed
+        };
+
+        const std::size_t stripes = (size - 1) / HASH_STRIPE_SIZE;
+        std::size_t stripe = 0;
+        for (; stripe + STRIPES_PER_BLOCK <= stripes; stripe += STRIPES_PER_BLOCK)
+        {
+            for (std::size_t n = 0; n < STRIPES_PER_BLOCK; ++n)
+            {
+                Lanes::accumulate(acc, p + (stripe + n) * HASH_STRIPE_SIZE, keys + n);
+            }
+            Lanes::scramble(acc, keys + SCRAMBLE_KEY);
+        }
+        for (std::size_t n = 0; stripe + n < stripes; ++n)
+        {
+            Lanes::accumulate(acc, p + (stripe + n) * HASH_STRIPE_SIZE, keys + n);
+        }
+        // The last stripe ends at the end of the input, it may overlap the previous one
+        Lanes::accumulate(acc, p + size - HASH_STRIPE_SIZE, keys + LAST_STRIPE_KEY);
+
+        std::uint64_t result = size * WY_SECRET[0] ^ seed;
+        for (std::size_t i = 0; i < 8; i += 2)
+        {
+            result += mix64(acc[i] ^ keys[SCRAMBLE_KEY + i], acc[i + 1] ^ keys[SCRAMBLE_KEY + i + 1]);
+        }
+        return mix64(result ^ WY_SECRET[1], result >> 29 ^ WY_SECRET[3]);
+    }
+
+#if defined(USEFULCPP_X86)
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    inline std::uint64_t avx2HashLong(const unsigned char* p, const std::size_t size, const std::uint64_t seed)
+    {
+        return hashLongKernel<Avx2HashLanes>(p, size, seed);
+    }
+#endif
+
+    //============================== Short path ====================================
+
+    ///=============================================================================
+    /// @brief wyhash-style hash of up to LONG_HASH_THRESHOLD bytes.
+    ///=============================================================================
+    inline std::uint64_t hashShort(const unsigned char* p,
+                                   const std::size_t size,
+                                   std::uint64_t seed) noexcept
+    {
+        seed ^= mix64(seed ^ WY_SECRET[0], WY_SECRET[1]);
+        std::uint64_t a;
+        std::uint64_t b;
+        if (size <= 16)
+        {
+            if (size >= 4)
+            {
+                // Two overlapping pairs of 4-byte reads cover 4 to 16 bytes
+                const std::size_t shift = (size >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + shift);
+                b = (read32(p + size - 4) << 32) | read32(p + size - 4 - shift);
+            }
+            else if (size > 0)
+            {
+                a = (static_cast<std::uint64_t>(p[0]) << 16) | (static_cast<std::uint64_t>(p[size >> 1]) << 8) | p[size - 1];
+                b = 0;
+            }
+            else
+            {
+                a = 0;
+                b = 0;
+            }
+        }
+        else
+        {
+            std::size_t rest = size;
+            if (rest > 48)
+            {
+                std::uint64_t seed1 = seed;
+                std::uint64_t seed2 = seed;
+                do
+                {
+                    seed = mix64(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ seed);
+                    seed1 = mix64(read64(p + 16) ^ WY_SECRET[2], read64(p + 24) ^ seed1);
+                    seed2 = mix64(read64(p + 32) ^ WY_SECRET[3], read64(p + 40) ^ seed2);
+                    p += 48;
+                    rest -= 48;
+                } while (rest > 48);
+                seed ^= seed1 ^ seed2;
+            }
+            while (rest > 16)
+            {
+                seed = mix64(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ seed);
+                p += 16;
+                rest -= 16;
+            }
+            a = read64(p + rest - 16);
+            b = read64(p + rest - 8);
+        }
+        a ^= WY_SECRET[1];
+        b ^= seed;
+        multiply128(a, b);
+        return mix64(a ^ WY_SECRET[0] ^ size, b ^ WY_SECRET[1]);
+    }
+
+    ///=============================================================================
+    /// @brief Hashes size bytes.
+    ///
+    /// @param const void* data - bytes to hash.
+    /// @param const std::size_t size - number of bytes.
+    /// @param const std::uint64_t seed - seed of the hash.
+    ///
+    /// @return std::uint64_t - the hash.
+    ///=============================================================================
+    inline std::uint64_t hashBytes(const void* data,
+                                   const std::size_t size,
+                                   const std::uint64_t seed = 0)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        if (size <= LONG_HASH_THRESHOLD)
+        {
+            return hashShort(p, size, seed);
+        }
+#if defined(USEFULCPP_X86)
+        if (cpuSupportsAvx2())
+        {
+            return avx2HashLong(p, size, seed);
+        }
+#endif
+#if defined(USEFULCPP_SSE2)
+        return hashLongKernel<Sse2HashLanes>(p, size, seed);
+#else
+        return hashLongKernel<ScalarHashLanes>(p, size, seed);
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Hashes size characters, for hash tables.
+    ///
+    /// @return std::size_t - the hash.
+    ///=============================================================================
+    template <typename CharT>
+    inline std::size_t hash(const CharT* data,
+                            const std::size_t size)
+    {
+        return static_cast<std::size_t>(hashBytes(data, size * sizeof(CharT)));
+    }
+}
+
+#endif // STRINGHASH_H
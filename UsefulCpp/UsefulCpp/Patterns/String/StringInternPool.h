@@ -0,0 +1,355 @@
+#ifndef STRINGINTERNPOOL_H
+#define STRINGINTERNPOOL_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string>         // for std::char_traits
+#include <vector>
+
+#include "String.h"
+#include "..\MonotonicArena\MonotonicArena.h"
+
+///=============================================================================
+/// String interning (hash consing): every distinct string is stored once in a
+/// pool, and the pool hands out InternedString handles of a single pointer.
+/// Two handles of the same pool are equal exactly when they point to the same
+/// entry, so equality is a pointer comparison whatever the length, and the
+/// hash is computed once, when the string is interned.
+///
+/// Interning is thread-safe: the pool is split into shards by hash, each with
+/// its own lock, table and arena, so threads interning different strings
+/// rarely wait for each other. Handles are immutable and may be used from any
+/// thread without locking. Entries live as long as the pool; the pool never
+/// shrinks.
+///
+/// Example of usage:
+/// CStringInternPool pool;
+/// InternedCString key = pool.intern("request_id");
+/// std::unordered_map<InternedCString, int> counters;   // hash is precomputed
+/// ++counters[key];
+/// if (key == pool.intern(headerName)) { ... }         // pointer comparison
+///=============================================================================
+
+///=============================================================================
+/// Immutable interned string: the precomputed hash and the size, followed by
+/// the characters and a terminator.
+///=============================================================================
+template <typename CharT>
+struct InternedEntry
+{
+    std::size_t hash;
+    std::size_t size;
+
+    const CharT* chars() const noexcept { return reinterpret_cast<const CharT*>(this + 1); }
+};
+
+///=============================================================================
+/// Handle to a string of a StringInternPool. Handles of different pools must
+/// not be compared.
+///=============================================================================
+template <typename CharT>
+class InternedString
+{
+public:
+    ///=============================================================================
+    /// @brief Default constructor. The handle refers to the empty string, which
+    ///        is the same for all the pools.
+    ///=============================================================================
+    InternedString() noexcept
+        : m_entry(emptyEntry())
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor, used by the pool.
+    ///
+    /// @param const InternedEntry<CharT>* entry - entry of the pool.
+    ///=============================================================================
+    explicit InternedString(const InternedEntry<CharT>* entry) noexcept
+        : m_entry(entry)
+    {}
+
+    ///=============================================================================
+    /// @brief Gets the characters, null-terminated.
+    ///=============================================================================
+    const CharT* data() const noexcept { return m_entry->chars(); }
+    const CharT* c_str() const noexcept { return m_entry->chars(); }
+
+    ///=============================================================================
+    /// @brief Gets the number of characters.
+    ///=============================================================================
+    std::size_t size() const noexcept { return m_entry->size; }
+
+    ///=============================================================================
+    /// @brief Checks whether the string is empty.
+    ///=============================================================================
+    bool empty() const noexcept { return m_entry->size == 0; }
+
+    ///=============================================================================
+    /// @brief Gets the hash computed when the string was interned.
+    ///=============================================================================
+    std::size_t hash() const noexcept { return m_entry->hash; }
+
+    ///=============================================================================
+    /// @brief Copies the characters into a String.
+    ///
+    /// @return String<CharT> - copy of the string.
+    ///=============================================================================
+    String<CharT> str() const
+    {
+        String<CharT> copy;
+        copy.append(data(), size());
+        return copy;
+    }
+
+    ///=============================================================================
+    /// @brief Gets the entry, unique per string in a pool.
+    ///=============================================================================
+    const InternedEntry<CharT>* entry() const noexcept { return m_entry; }
+
+    ///=============================================================================
+    /// @brief Gets the entry of the empty string, shared by all the pools.
+    ///=============================================================================
+    static const InternedEntry<CharT>* emptyEntry() noexcept
+    {
+        struct EmptyEntry
+        {
+            InternedEntry<CharT> entry;
+            CharT                terminator;
+        };
+        static const EmptyEntry empty = { { StringKernels::hash(static_cast<const CharT*>(nullptr), 0), 0 }, CharT() };
+        return &empty.entry;
+    }
+
+private:
+    const InternedEntry<CharT>* m_entry;
+};
+
+//======================== Comparison operators ================================
+
+///=============================================================================
+///=============================================================================
+template <typename CharT>
+inline bool operator==(const InternedString<CharT>& lhs, const InternedString<CharT>& rhs) noexcept
+{
+    return lhs.entry() == rhs.entry();
+}
+
+///=============================================================================
+///=============================================================================
+template <typename CharT>
+inline bool operator!=(const InternedString<CharT>& lhs, const InternedString<CharT>& rhs) noexcept
+{
+    return lhs.entry() != rhs.entry();
+}
+
+///=============================================================================
+/// Arbitrary but stable order (by address), for ordered containers.
+///=============================================================================
+template <typename CharT>
+inline bool operator<(const InternedString<CharT>& lhs, const InternedString<CharT>& rhs) noexcept
+{
+    return std::less<const InternedEntry<CharT>*>()(lhs.entry(), rhs.entry());
+}
+
+///=============================================================================
+/// Hash of a handle: the precomputed one.
+///=============================================================================
+namespace std
+{
+    template <typename CharT>
+    struct hash<InternedString<CharT>>
+    {
+        std::size_t operator()(const InternedString<CharT>& str) const noexcept
+        {
+            return str.hash();
+        }
+    };
+}
+
+///=============================================================================
+/// The pool of interned strings.
+///=============================================================================
+template <typename CharT>
+class StringInternPool
+{
+public:
+    // Number of independently locked parts of the pool
+    static constexpr std::size_t SHARD_COUNT = 64;
+
+    ///=============================================================================
+    /// @brief Constructor.
+    ///=============================================================================
+    StringInternPool() = default;
+
+    StringInternPool(const StringInternPool&) = delete;
+    StringInternPool& operator=(const StringInternPool&) = delete;
+
+    ///=============================================================================
+    /// @brief Interns size characters: returns the handle of the equal string
+    ///        of the pool, adding a copy of the characters if there is none.
+    ///
+    /// @param const CharT* data - characters.
+    /// @param const std::size_t size - number of characters.
+    ///
+    /// @return InternedString<CharT> - handle of the string.
+    ///=============================================================================
+    InternedString<CharT> intern(const CharT* data,
+                                 const std::size_t size)
+    {
+        if (size == 0)
+        {
+            return InternedString<CharT>();
+        }
+
+        const std::size_t hash = StringKernels::hash(data, size);
+        Shard& shard = m_shards[hash % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const InternedEntry<CharT>** slot = shard.find(hash, data, size);
+        const InternedEntry<CharT>* entry = *slot;
+        if (entry == nullptr)
+        {
+            entry = shard.add(hash, data, size);
+            *slot = entry;
+            if (shard.needsGrowth())
+            {
+                shard.grow();
+            }
+        }
+        return InternedString<CharT>(entry);
+    }
+
+    ///=============================================================================
+    /// @brief Interns a c-string.
+    ///=============================================================================
+    InternedString<CharT> intern(const CharT* cstr)
+    {
+        return intern(cstr, std::char_traits<CharT>::length(cstr));
+    }
+
+    ///=============================================================================
+    /// @brief Interns a String.
+    ///=============================================================================
+    template <typename Allocator>
+    InternedString<CharT> intern(const String<CharT, Allocator>& str)
+    {
+        return intern(str.begin(), str.size());
+    }
+
+    ///=============================================================================
+    /// @brief Gets the number of distinct non-empty strings in the pool.
+    ///=============================================================================
+    std::size_t size() const
+    {
+        std::size_t count = 0;
+        for (const Shard& shard : m_shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            count += shard.count;
+        }
+        return count;
+    }
+
+private:
+    ///=============================================================================
+    /// Part of the pool: open addressing table with linear probing over the
+    /// entries, which are allocated from the arena of the shard. Aligned to a
+    /// cache line, so that shards locked by different threads do not share one.
+    ///=============================================================================
+    struct alignas(64) Shard
+    {
+        // Initial number of slots, a power of two
+        static constexpr std::size_t INITIAL_SLOTS = 64;
+
+        // First chunk of the arena, small as most shards hold few strings
+        static constexpr std::size_t INITIAL_CHUNK_SIZE = 4096;
+
+        Shard()
+            : table(INITIAL_SLOTS, nullptr)
+            , count(0)
+            , arena(INITIAL_CHUNK_SIZE)
+        {}
+
+        ///=============================================================================
+        /// @brief Finds the slot of the equal string, or the empty slot where it
+        ///        belongs.
+        ///=============================================================================
+        const InternedEntry<CharT>** find(const std::size_t hash,
+                                          const CharT* data,
+                                          const std::size_t size)
+        {
+            const std::size_t mask = table.size() - 1;
+            for (std::size_t index = (hash / SHARD_COUNT) & mask; ; index = (index + 1) & mask)
+            {
+                const InternedEntry<CharT>* entry = table[index];
+                if (entry == nullptr ||
+                    (entry->hash == hash && entry->size == size &&
+                     StringKernels::mismatch(entry->chars(), data, size) == size))
+                {
+                    return &table[index];
+                }
+            }
+        }
+
+        ///=============================================================================
+        /// @brief Copies the string into a new entry of the arena.
+        ///=============================================================================
+        const InternedEntry<CharT>* add(const std::size_t hash,
+                                        const CharT* data,
+                                        const std::size_t size)
+        {
+            void* memory = arena.allocate(sizeof(InternedEntry<CharT>) + (size + 1) * sizeof(CharT),
+                                          alignof(InternedEntry<CharT>));
+            InternedEntry<CharT>* entry = new (memory) InternedEntry<CharT>{ hash, size };
+            CharT* chars = reinterpret_cast<CharT*>(entry + 1);
+            std::char_traits<CharT>::copy(chars, data, size);
+            chars[size] = CharT();
+            ++count;
+            return entry;
+        }
+
+        ///=============================================================================
+        /// @brief Checks whether the table is more than half full.
+        ///=============================================================================
+        bool needsGrowth() const noexcept { return 2 * count > table.size(); }
+
+        ///=============================================================================
+        /// @brief Doubles the table, the stored hashes place the entries.
+        ///=============================================================================
+        void grow()
+        {
+            std::vector<const InternedEntry<CharT>*> grown(2 * table.size(), nullptr);
+            const std::size_t mask = grown.size() - 1;
+            for (const InternedEntry<CharT>* entry : table)
+            {
+                if (entry != nullptr)
+                {
+                    std::size_t index = (entry->hash / SHARD_COUNT) & mask;
+                    while (grown[index] != nullptr)
+                    {
+                        index = (index + 1) & mask;
+                    }
+                    grown[index] = entry;
+                }
+            }
+            table.swap(grown);
+        }
+
+        mutable std::mutex                       mutex;
+        std::vector<const InternedEntry<CharT>*> table;
+        std::size_t                              count;
+        MonotonicArena                           arena;
+    };
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+};
+
+using InternedCString = InternedString<char>;
+using InternedWString = InternedString<wchar_t>;
+using CStringInternPool = StringInternPool<char>;
+using WStringInternPool = StringInternPool<wchar_t>;
+
+#endif // STRINGINTERNPOOL_H
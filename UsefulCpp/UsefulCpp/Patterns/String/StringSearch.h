@@ -0,0 +1,823 @@
+#ifndef STRINGSEARCH_H
+#define STRINGSEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>    // for std::char_traits
+#include <type_traits>
+
+#include "..\..\Platform\CpuFeatures.h"
+
+///=============================================================================
+/// Comparison and search kernels over characters given by pointer and length,
+/// for char and wchar_t (2 or 4 bytes). Nothing has to be null-terminated and
+/// nothing is read past data + size.
+///
+/// The kernels process a register of characters per step: 16 bytes with SSE2,
+/// 32 bytes with AVX2 if the CPU supports it (checked once at runtime). The
+/// rest of the input, shorter than a register, is processed character by
+/// character, like the whole input on other targets.
+///
+/// Substring search compares the first and the last character of the needle
+/// with a register of candidate positions at once, and only the positions
+/// which match both are compared in full.
+///
+/// Example of usage:
+/// const char text[] = "key=value; path=/usr/local";
+/// std::size_t at = StringKernels::find(text, sizeof(text) - 1, "path=", 5);      // 11
+/// std::size_t semicolon = StringKernels::findFirstOf(text, sizeof(text) - 1, ";,", 2); // 9
+///=============================================================================
+namespace StringKernels
+{
+    // Returned by the searches when nothing is found
+    constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+    // Sets of up to that many characters are searched with SIMD by
+    // findFirstOf(), larger ones with a lookup table
+    constexpr std::size_t SIMD_SET_MAX_SIZE = 8;
+
+    ///=============================================================================
+    /// @brief Index of the lowest set bit, mask must not be 0.
+    ///=============================================================================
+    inline unsigned lowestBit(const std::uint32_t mask) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    ///=============================================================================
+    /// @brief Index of the highest set bit, mask must not be 0.
+    ///=============================================================================
+    inline unsigned highestBit(const std::uint32_t mask) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+    }
+
+#if defined(USEFULCPP_SSE2)
+    ///=============================================================================
+    /// SSE2 register of 16 bytes. Masks have a bit per byte, so a character of
+    /// CHAR_SIZE bytes sets CHAR_SIZE adjacent bits.
+    ///=============================================================================
+    struct Sse2Register
+    {
+        using Register = __m128i;
+        static constexpr std::size_t BYTES = 16;
+        static constexpr std::uint32_t FULL_MASK = 0xFFFFu;
+
+        static Register load(const void* data)
+        {
+            return _mm_loadu_si128(static_cast<const __m128i*>(data));
+        }
+
+        static Register both(const Register a, const Register b) { return _mm_and_si128(a, b); }
+        static Register either(const Register a, const Register b) { return _mm_or_si128(a, b); }
+        static std::uint32_t mask(const Register v) { return static_cast<std::uint32_t>(_mm_movemask_epi8(v)); }
+    };
+
+    ///=============================================================================
+    /// Character lanes of CHAR_SIZE bytes of an SSE2 register.
+    ///=============================================================================
+    template <std::size_t CHAR_SIZE>
+    struct Sse2Lanes;
+
+    template <>
+    struct Sse2Lanes<1> : Sse2Register
+    {
+        static Register broadcast(const std::uint32_t c) { return _mm_set1_epi8(static_cast<char>(c)); }
+        static Register equal(const Register a, const Register b) { return _mm_cmpeq_epi8(a, b); }
+    };
+
+    template <>
+    struct Sse2Lanes<2> : Sse2Register
+    {
+        static Register broadcast(const std::uint32_t c) { return _mm_set1_epi16(static_cast<short>(c)); }
+        static Register equal(const Register a, const Register b) { return _mm_cmpeq_epi16(a, b); }
+    };
+
+    template <>
+    struct Sse2Lanes<4> : Sse2Register
+    {
+        static Register broadcast(const std::uint32_t c) { return _mm_set1_epi32(static_cast<int>(c)); }
+        static Register equal(const Register a, const Register b) { return _mm_cmpeq_epi32(a, b); }
+    };
+
+    ///=============================================================================
+    /// Operations of the generic kernels over SSE2 lanes, see ScalarMatcher.
+    ///=============================================================================
+    template <std::size_t CHAR_SIZE>
+    struct Sse2Matcher
+    {
+        using Lanes = Sse2Lanes<CHAR_SIZE>;
+        using Register = typename Lanes::Register;
+        static constexpr std::size_t BYTES = Lanes::BYTES;
+        static constexpr std::uint32_t FULL_MASK = Lanes::FULL_MASK;
+
+        static void broadcast(Register& needle, const std::uint32_t c)
+        {
+            needle = Lanes::broadcast(c);
+        }
+
+        static std::uint32_t equalMask(const void* lhs, const void* rhs)
+        {
+            return Lanes::mask(Lanes::equal(Lanes::load(lhs), Lanes::load(rhs)));
+        }
+
+        static std::uint32_t matchMask(const void* data, const Register& needle)
+        {
+            return Lanes::mask(Lanes::equal(Lanes::load(data), needle));
+        }
+
+        static std::uint32_t matchAnyMask(const void* data, const Register* needles, const std::size_t count)
+        {
+            const Register block = Lanes::load(data);
+            Register matches = Lanes::equal(block, needles[0]);
+            for (std::size_t i = 1; i < count; ++i)
+            {
+                matches = Lanes::either(matches, Lanes::equal(block, needles[i]));
+            }
+            return Lanes::mask(matches);
+        }
+
+        static std::uint32_t matchBothMask(const void* data, const Register& needle,
+                                           const void* otherData, const Register& otherNeedle)
+        {
+            return Lanes::mask(Lanes::both(Lanes::equal(Lanes::load(data), needle),
+                                           Lanes::equal(Lanes::load(otherData), otherNeedle)));
+        }
+    };
+#endif // USEFULCPP_SSE2
+
+#if defined(USEFULCPP_X86)
+    ///=============================================================================
+    /// AVX2 register of 32 bytes, see Sse2Register.
+    ///=============================================================================
+    struct Avx2Register
+    {
+        using Register = __m256i;
+        static constexpr std::size_t BYTES = 32;
+        static constexpr std::uint32_t FULL_MASK = 0xFFFFFFFFu;
+
+        USEFULCPP_TARGET_AVX2 static Register load(const void* data)
+        {
+            return _mm256_loadu_si256(static_cast<const __m256i*>(data));
+        }
+
+        USEFULCPP_TARGET_AVX2 static Register both(const Register a, const Register b) { return _mm256_and_si256(a, b); }
+        USEFULCPP_TARGET_AVX2 static Register either(const Register a, const Register b) { return _mm256_or_si256(a, b); }
+        USEFULCPP_TARGET_AVX2 static std::uint32_t mask(const Register v) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(v)); }
+    };
+
+    ///=============================================================================
+    /// Character lanes of CHAR_SIZE bytes of an AVX2 register.
+    ///=============================================================================
+    template <std::size_t CHAR_SIZE>
+    struct Avx2Lanes;
+
+    template <>
+    struct Avx2Lanes<1> : Avx2Register
+    {
+        USEFULCPP_TARGET_AVX2 static Register broadcast(const std::uint32_t c) { return _mm256_set1_epi8(static_cast<char>(c)); }
+        USEFULCPP_TARGET_AVX2 static Register equal(const Register a, const Register b) { return _mm256_cmpeq_epi8(a, b); }
+    };
+
+    template <>
+    struct Avx2Lanes<2> : Avx2Register
+    {
+        USEFULCPP_TARGET_AVX2 static Register broadcast(const std::uint32_t c) { return _mm256_set1_epi16(static_cast<short>(c)); }
+        USEFULCPP_TARGET_AVX2 static Register equal(const Register a, const Register b) { return _mm256_cmpeq_epi16(a, b); }
+    };
+
+    template <>
+    struct Avx2Lanes<4> : Avx2Register
+    {
+        USEFULCPP_TARGET_AVX2 static Register broadcast(const std::uint32_t c) { return _mm256_set1_epi32(static_cast<int>(c)); }
+        USEFULCPP_TARGET_AVX2 static Register equal(const Register a, const Register b) { return _mm256_cmpeq_epi32(a, b); }
+    };
+
+    ///=============================================================================
+    /// Operations of the generic kernels over AVX2 lanes, see ScalarMatcher.
+    ///=============================================================================
+    template <std::size_t CHAR_SIZE>
+    struct Avx2Matcher
+    {
+        using Lanes = Avx2Lanes<CHAR_SIZE>;
+        using Register = typename Lanes::Register;
+        static constexpr std::size_t BYTES = Lanes::BYTES;
+        static constexpr std::uint32_t FULL_MASK = Lanes::FULL_MASK;
+
+        USEFULCPP_TARGET_AVX2 static void broadcast(Register& needle, const std::uint32_t c)
+        {
+            needle = Lanes::broadcast(c);
+        }
+
+        USEFULCPP_TARGET_AVX2 static std::uint32_t equalMask(const void* lhs, const void* rhs)
+        {
+            return Lanes::mask(Lanes::equal(Lanes::load(lhs), Lanes::load(rhs)));
+        }
+
+        USEFULCPP_TARGET_AVX2 static std::uint32_t matchMask(const void* data, const Register& needle)
+        {
+            return Lanes::mask(Lanes::equal(Lanes::load(data), needle));
+        }
+
+        USEFULCPP_TARGET_AVX2 static std::uint32_t matchAnyMask(const void* data, const Register* needles, const std::size_t count)
+        {
+            const Register block = Lanes::load(data);
+            Register matches = Lanes::equal(block, needles[0]);
+            for (std::size_t i = 1; i < count; ++i)
+            {
+                matches = Lanes::either(matches, Lanes::equal(block, needles[i]));
+            }
+            return Lanes::mask(matches);
+        }
+
+        USEFULCPP_TARGET_AVX2 static std::uint32_t matchBothMask(const void* data, const Register& needle,
+                                                                 const void* otherData, const Register& otherNeedle)
+        {
+            return Lanes::mask(Lanes::both(Lanes::equal(Lanes::load(data), needle),
+                                           Lanes::equal(Lanes::load(otherData), otherNeedle)));
+        }
+    };
+#endif // USEFULCPP_X86
+
+    ///=============================================================================
+    /// @brief Code of a character as an unsigned value, for broadcasts and
+    ///        lookup tables.
+    ///=============================================================================
+    template <typename CharT>
+    inline std::uint32_t charCode(const CharT c) noexcept
+    {
+        return static_cast<std::uint32_t>(static_cast<typename std::make_unsigned<CharT>::type>(c));
+    }
+
+    ///=============================================================================
+    /// Scalar instantiation of the kernels: a "register" of a single character.
+    ///
+    /// The generic kernels only see matchers: registers go by reference and the
+    /// results come back as bit masks, never as registers. The AVX2 matchers
+    /// are thus called with the same ABI from the kernels whether or not the
+    /// kernels got inlined into their AVX2 entry point (they are not in builds
+    /// without optimizations).
+    ///=============================================================================
+    template <typename CharT>
+    struct ScalarMatcher
+    {
+        using Register = CharT;
+        static constexpr std::size_t BYTES = sizeof(CharT);
+        static constexpr std::uint32_t FULL_MASK = (1u << sizeof(CharT)) - 1;
+
+        static void broadcast(Register& needle, const std::uint32_t c) { needle = static_cast<CharT>(c); }
+
+        static std::uint32_t equalMask(const void* lhs, const void* rhs)
+        {
+            return *static_cast<const CharT*>(lhs) == *static_cast<const CharT*>(rhs) ? FULL_MASK : 0;
+        }
+
+        static std::uint32_t matchMask(const void* data, const Register& needle)
+        {
+            return *static_cast<const CharT*>(data) == needle ? FULL_MASK : 0;
+        }
+
+        static std::uint32_t matchAnyMask(const void* data, const Register* needles, const std::size_t count)
+        {
+            return std::char_traits<CharT>::find(needles, count, *static_cast<const CharT*>(data)) != nullptr ? FULL_MASK : 0;
+        }
+
+        static std::uint32_t matchBothMask(const void* data, const Register& needle,
+                                           const void* otherData, const Register& otherNeedle)
+        {
+            return matchMask(data, needle) & matchMask(otherData, otherNeedle);
+        }
+    };
+
+    //=============================== Generic kernels ==============================
+    // Matcher is one of the matcher types above; the kernels start with the
+    // vector loop and finish with the scalar one, from where the vector loop
+    // stopped.
+
+    ///=============================================================================
+    /// @brief Index of the first position where lhs and rhs differ, or size.
+    ///=============================================================================
+    template <typename Matcher, typename CharT>
+    std::size_t mismatchKernel(const CharT* lhs,
+                               const CharT* rhs,
+                               const std::size_t size)
+    {
+        constexpr std::size_t STEP = Matcher::BYTES / sizeof(CharT);
+        std::size_t i = 0;
+        for (; i + STEP <= size; i += STEP)
+        {
+            const std::uint32_t equal = Matcher::equalMask(lhs + i, rhs + i);
+            if (equal != Matcher::FULL_MASK)
+            {
+                return i + lowestBit(~equal & Matcher::FULL_MASK) / sizeof(CharT);
+            }
+        }
+        for (; i < size; ++i)
+        {
+            if (lhs[i] != rhs[i])
+            {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    ///=============================================================================
+    /// @brief Index of the first c in [pos, size), or NOT_FOUND.
+    ///=============================================================================
+    template <typename Matcher, typename CharT>
+    std::size_t findCharKernel(const CharT* data,
+                               const std::size_t size,
+                               const CharT c,
+                               std::size_t pos)
+    {
+        constexpr std::size_t STEP = Matcher::BYTES / sizeof(CharT);
+        typename Matcher::Register needle;
+        Matcher::broadcast(needle, charCode(c));
+        for (; pos + STEP <= size; pos += STEP)
+        {
+            const std::uint32_t found = Matcher::matchMask(data + pos, needle);
+            if (found != 0)
+            {
+                return pos + lowestBit(found) / sizeof(CharT);
+            }
+        }
+        for (; pos < size; ++pos)
+        {
+            if (data[pos] == c)
+            {
+                return pos;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    ///=============================================================================
+    /// @brief Index of the last c in [0, end), or NOT_FOUND.
+    ///=============================================================================
+    template <typename Matcher, typename CharT>
+    std::size_t rfindCharKernel(const CharT* data,
+                                std::size_t end,
+                                const CharT c)
+    {
+        constexpr std::size_t STEP = Matcher::BYTES / sizeof(CharT);
+        typename Matcher::Register needle;
+        Matcher::broadcast(needle, charCode(c));
+        for (; end >= STEP; end -= STEP)
+        {
+            const std::uint32_t found = Matcher::matchMask(data + end - STEP, needle);
+            if (found != 0)
+            {
+                return end - STEP + highestBit(found) / sizeof(CharT);
+            }
+        }
+        while (end-- > 0)
+        {
+            if (data[end] == c)
+            {
+                return end;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    ///=============================================================================
+    /// @brief Index of the first character of [pos, size) which is one of the
+    ///        setSize (1 to SIMD_SET_MAX_SIZE) characters of set, or NOT_FOUND.
+    ///=============================================================================
+    template <typename Matcher, typename CharT>
+    std::size_t findAnyKernel(const CharT* data,
+                              const std::size_t size,
+                              const CharT* set,
+                              const std::size_t setSize,
+                              std::size_t pos)
+    {
+        constexpr std::size_t STEP = Matcher::BYTES / sizeof(CharT);
+        typename Matcher::Register needles[SIMD_SET_MAX_SIZE];
+        for (std::size_t i = 0; i < setSize; ++i)
+        {
+            Matcher::broadcast(needles[i], charCode(set[i]));
+        }
+        for (; pos + STEP <= size; pos += STEP)
+        {
+            const std::uint32_t found = Matcher::matchAnyMask(data + pos, needles, setSize);
+            if (found != 0)
+            {
+                return pos + lowestBit(found) / sizeof(CharT);
+            }
+        }
+        for (; pos < size; ++pos)
+        {
+            if (std::char_traits<CharT>::find(set, setSize, data[pos]) != nullptr)
+            {
+                return pos;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    ///=============================================================================
+    /// @brief Index of the first occurrence of the needle (2 characters or more)
+    ///        which starts in [pos, size - needleSize], or NOT_FOUND.
+    ///=============================================================================
+    template <typename Matcher, typename CharT>
+    std::size_t findSubstringKernel(const CharT* data,
+                                    const std::size_t size,
+                                    const CharT* needle,
+                                    const std::size_t needleSize,
+                                    std::size_t pos)
+    {
+        constexpr std::size_t STEP = Matcher::BYTES / sizeof(CharT);
+        constexpr std::uint32_t CHAR_MASK = (1u << sizeof(CharT)) - 1;
+        const std::size_t lastStart = size - needleSize;
+        typename Matcher::Register first;
+        typename Matcher::Register last;
+        Matcher::broadcast(first, charCode(needle[0]));
+        Matcher::broadcast(last, charCode(needle[needleSize - 1]));
+
+        // The block of the last characters ends at pos + needleSize - 1 + STEP
+        for (; pos + STEP <= lastStart + 1; pos += STEP)
+        {
+            std::uint32_t candidates = Matcher::matchBothMask(data + pos, first, data + pos + needleSize - 1, last);
+            while (candidates != 0)
+            {
+                const unsigned bit = lowestBit(candidates);
+                const std::size_t start = pos + bit / sizeof(CharT);
+                if (std::char_traits<CharT>::compare(data + start + 1, needle + 1, needleSize - 2) == 0)
+                {
+                    return start;
+                }
+                candidates &= ~(CHAR_MASK << bit);
+            }
+        }
+        for (; pos <= lastStart; ++pos)
+        {
+            if (data[pos] == needle[0] &&
+                std::char_traits<CharT>::compare(data + pos + 1, needle + 1, needleSize - 1) == 0)
+            {
+                return pos;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    ///=============================================================================
+    /// @brief Index of the last occurrence of the needle (2 characters or more)
+    ///        which starts in [0, end), or NOT_FOUND. end must not be greater
+    ///        than size - needleSize + 1.
+    ///=============================================================================
+    template <typename Matcher, typename CharT>
+    std::size_t rfindSubstringKernel(const CharT* data,
+                                     std::size_t end,
+                                     const CharT* needle,
+                                     const std::size_t needleSize)
+    {
+        constexpr std::size_t STEP = Matcher::BYTES / sizeof(CharT);
+        constexpr std::uint32_t CHAR_MASK = (1u << sizeof(CharT)) - 1;
+        typename Matcher::Register first;
+        typename Matcher::Register last;
+        Matcher::broadcast(first, charCode(needle[0]));
+        Matcher::broadcast(last, charCode(needle[needleSize - 1]));
+
+        for (; end >= STEP; end -= STEP)
+        {
+            const std::size_t pos = end - STEP;
+            std::uint32_t candidates = Matcher::matchBothMask(data + pos, first, data + pos + needleSize - 1, last);
+            while (candidates != 0)
+            {
+                // The highest bit of the highest matching character
+                const unsigned bit = highestBit(candidates) + 1 - sizeof(CharT);
+                const std::size_t start = pos + bit / sizeof(CharT);
+                if (std::char_traits<CharT>::compare(data + start + 1, needle + 1, needleSize - 2) == 0)
+                {
+                    return start;
+                }
+                candidates &= ~(CHAR_MASK << bit);
+            }
+        }
+        while (end-- > 0)
+        {
+            if (data[end] == needle[0] &&
+                std::char_traits<CharT>::compare(data + end + 1, needle + 1, needleSize - 1) == 0)
+            {
+                return end;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    //================================ Dispatching =================================
+    // The AVX2 entry points are compiled for AVX2 and flatten the kernels
+    // they instantiate (the AVX2 matchers are compiled for AVX2 on their own,
+    // see ScalarMatcher); they run only if the CPU supports it. Below a
+    // register of input they are not worth the check.
+
+#if defined(USEFULCPP_X86)
+    template <typename CharT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2Mismatch(const CharT* lhs, const CharT* rhs, const std::size_t size)
+    {
+        return mismatchKernel<Avx2Matcher<sizeof(CharT)>>(lhs, rhs, size);
+    }
+
+    template <typename CharT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2FindChar(const CharT* data, const std::size_t size, const CharT c, const std::size_t pos)
+    {
+        return findCharKernel<Avx2Matcher<sizeof(CharT)>>(data, size, c, pos);
+    }
+
+    template <typename CharT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2RfindChar(const CharT* data, const std::size_t end, const CharT c)
+    {
+        return rfindCharKernel<Avx2Matcher<sizeof(CharT)>>(data, end, c);
+    }
+
+    template <typename CharT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2FindAny(const CharT* data, const std::size_t size,
+                            const CharT* set, const std::size_t setSize, const std::size_t pos)
+    {
+        return findAnyKernel<Avx2Matcher<sizeof(CharT)>>(data, size, set, setSize, pos);
+    }
+
+    template <typename CharT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2FindSubstring(const CharT* data, const std::size_t size,
+                                  const CharT* needle, const std::size_t needleSize, const std::size_t pos)
+    {
+        return findSubstringKernel<Avx2Matcher<sizeof(CharT)>>(data, size, needle, needleSize, pos);
+    }
+
+    template <typename CharT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2RfindSubstring(const CharT* data, const std::size_t end,
+                                   const CharT* needle, const std::size_t needleSize)
+    {
+        return rfindSubstringKernel<Avx2Matcher<sizeof(CharT)>>(data, end, needle, needleSize);
+    }
+#endif // USEFULCPP_X86
+
+    ///=============================================================================
+    /// @brief Checks whether the AVX2 kernels should process count characters.
+    ///=============================================================================
+    template <typename CharT>
+    inline bool useAvx2(const std::size_t count)
+    {
+#if defined(USEFULCPP_X86)
+        return count >= 32 / sizeof(CharT) && cpuSupportsAvx2();
+#else
+        (void)count;
+        return false;
+#endif
+    }
+
+#if defined(USEFULCPP_SSE2)
+    template <typename CharT>
+    using DefaultMatcher = Sse2Matcher<sizeof(CharT)>;
+#else
+    template <typename CharT>
+    using DefaultMatcher = ScalarMatcher<CharT>;
+#endif
+
+    ///=============================================================================
+    /// @brief Finds the first position where two ranges of the same length
+    ///        differ.
+    ///
+    /// @param const CharT* lhs - first range.
+    /// @param const CharT* rhs - second range.
+    /// @param const std::size_t size - number of characters of each range.
+    ///
+    /// @return std::size_t - index of the first difference, size if equal.
+    ///=============================================================================
+    template <typename CharT>
+    std::size_t mismatch(const CharT* lhs,
+                         const CharT* rhs,
+                         const std::size_t size)
+    {
+#if defined(USEFULCPP_X86)
+        if (useAvx2<CharT>(size))
+        {
+            return avx2Mismatch(lhs, rhs, size);
+        }
+#endif
+        return mismatchKernel<DefaultMatcher<CharT>>(lhs, rhs, size);
+    }
+
+    ///=============================================================================
+    /// @brief Checks two strings for equality.
+    ///
+    /// @return true if the lengths and all the characters are equal.
+    ///=============================================================================
+    template <typename CharT>
+    bool equal(const CharT* lhs,
+               const std::size_t lhsSize,
+               const CharT* rhs,
+               const std::size_t rhsSize)
+    {
+        return lhsSize == rhsSize && (lhs == rhs || mismatch(lhs, rhs, lhsSize) == lhsSize);
+    }
+
+    ///=============================================================================
+    /// @brief Three-way lexicographical comparison, characters are ordered by
+    ///        std::char_traits (as unsigned for char), like std::basic_string.
+    ///
+    /// @return int - negative if lhs goes first, 0 if equal, positive otherwise.
+    ///=============================================================================
+    template <typename CharT>
+    int compare(const CharT* lhs,
+                const std::size_t lhsSize,
+                const CharT* rhs,
+                const std::size_t rhsSize)
+    {
+        const std::size_t common = lhsSize < rhsSize ? lhsSize : rhsSize;
+        const std::size_t at = lhs == rhs ? common : mismatch(lhs, rhs, common);
+        if (at < common)
+        {
+            return std::char_traits<CharT>::lt(lhs[at], rhs[at]) ? -1 : 1;
+        }
+        return lhsSize < rhsSize ? -1 : (lhsSize > rhsSize ? 1 : 0);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of a character at or after pos.
+    ///
+    /// @return std::size_t - index of the character, or NOT_FOUND.
+    ///=============================================================================
+    template <typename CharT>
+    std::size_t find(const CharT* data,
+                     const std::size_t size,
+                     const CharT c,
+                     const std::size_t pos = 0)
+    {
+        if (pos >= size)
+        {
+            return NOT_FOUND;
+        }
+#if defined(USEFULCPP_X86)
+        if (useAvx2<CharT>(size - pos))
+        {
+            return avx2FindChar(data, size, c, pos);
+        }
+#endif
+        return findCharKernel<DefaultMatcher<CharT>>(data, size, c, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of a character at or before pos.
+    ///
+    /// @return std::size_t - index of the character, or NOT_FOUND.
+    ///=============================================================================
+    template <typename CharT>
+    std::size_t rfind(const CharT* data,
+                      const std::size_t size,
+                      const CharT c,
+                      const std::size_t pos = NOT_FOUND)
+    {
+        const std::size_t end = pos < size ? pos + 1 : size;
+#if defined(USEFULCPP_X86)
+        if (useAvx2<CharT>(end))
+        {
+            return avx2RfindChar(data, end, c);
+        }
+#endif
+        return rfindCharKernel<DefaultMatcher<CharT>>(data, end, c);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of a substring which starts at or after
+    ///        pos. An empty needle is found at pos, if pos <= size.
+    ///
+    /// @return std::size_t - index of the substring, or NOT_FOUND.
+    ///=============================================================================
+    template <typename CharT>
+    std::size_t find(const CharT* data,
+                     const std::size_t size,
+                     const CharT* needle,
+                     const std::size_t needleSize,
+                     const std::size_t pos = 0)
+    {
+        if (needleSize == 0)
+        {
+            return pos <= size ? pos : NOT_FOUND;
+        }
+        if (needleSize == 1)
+        {
+            return find(data, size, needle[0], pos);
+        }
+        if (pos >= size || size - pos < needleSize)
+        {
+            return NOT_FOUND;
+        }
+#if defined(USEFULCPP_X86)
+        if (useAvx2<CharT>(size - pos - needleSize + 1))
+        {
+            return avx2FindSubstring(data, size, needle, needleSize, pos);
+        }
+#endif
+        return findSubstringKernel<DefaultMatcher<CharT>>(data, size, needle, needleSize, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of a substring which starts at or before
+    ///        pos. An empty needle is found at min(pos, size).
+    ///
+    /// @return std::size_t - index of the substring, or NOT_FOUND.
+    ///=============================================================================
+    template <typename CharT>
+    std::size_t rfind(const CharT* data,
+                      const std::size_t size,
+                      const CharT* needle,
+                      const std::size_t needleSize,
+                      const std::size_t pos = NOT_FOUND)
+    {
+        if (needleSize > size)
+        {
+            return NOT_FOUND;
+        }
+        const std::size_t lastStart = size - needleSize;
+        if (needleSize == 0)
+        {
+            return pos < lastStart ? pos : lastStart;
+        }
+        if (needleSize == 1)
+        {
+            return rfind(data, size, needle[0], pos);
+        }
+        const std::size_t end = (pos < lastStart ? pos : lastStart) + 1;
+#if defined(USEFULCPP_X86)
+        if (useAvx2<CharT>(end))
+        {
+            return avx2RfindSubstring(data, end, needle, needleSize);
+        }
+#endif
+        return rfindSubstringKernel<DefaultMatcher<CharT>>(data, end, needle, needleSize);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first character at or after pos which is one of the
+    ///        characters of the set.
+    ///
+    /// @return std::size_t - index of the character, or NOT_FOUND.
+    ///=============================================================================
+    template <typename CharT>
+    std::size_t findFirstOf(const CharT* data,
+                            const std::size_t size,
+                            const CharT* set,
+                            const std::size_t setSize,
+                            std::size_t pos = 0)
+    {
+        if (pos >= size || setSize == 0)
+        {
+            return NOT_FOUND;
+        }
+        if (setSize == 1)
+        {
+            return find(data, size, set[0], pos);
+        }
+        if (setSize <= SIMD_SET_MAX_SIZE)
+        {
+#if defined(USEFULCPP_X86)
+            if (useAvx2<CharT>(size - pos))
+            {
+                return avx2FindAny(data, size, set, setSize, pos);
+            }
+#endif
+            return findAnyKernel<DefaultMatcher<CharT>>(data, size, set, setSize, pos);
+        }
+
+        // Bitmap of the low bytes of the set: exact for char, a filter for wider
+        // characters
+        std::uint32_t bitmap[256 / 32] = {};
+        for (std::size_t i = 0; i < setSize; ++i)
+        {
+            const std::uint32_t low = charCode(set[i]) & 0xFFu;
+            bitmap[low / 32] |= 1u << (low % 32);
+        }
+        for (; pos < size; ++pos)
+        {
+            const std::uint32_t low = charCode(data[pos]) & 0xFFu;
+            if ((bitmap[low / 32] & (1u << (low % 32))) != 0 &&
+                (sizeof(CharT) == 1 || std::char_traits<CharT>::find(set, setSize, data[pos]) != nullptr))
+            {
+                return pos;
+            }
+        }
+        return NOT_FOUND;
+    }
+}
+
+#endif // STRINGSEARCH_H
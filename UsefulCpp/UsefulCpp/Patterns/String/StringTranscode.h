@@ -0,0 +1,740 @@
+#ifndef STRINGTRANSCODE_H
+#define STRINGTRANSCODE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "String.h"
+#include "..\..\Platform\CpuFeatures.h"
+
+///=============================================================================
+/// Validated transcoding between UTF-8 (CString) and the wchar_t encoding
+/// (WString): UTF-16 where wchar_t has 2 bytes (Windows), UTF-32 where it has
+/// 4 bytes. The result is written in place into the destination String,
+/// sized once beforehand: UTF-8 to wide reserves one wide character per
+/// byte, wide to UTF-8 counts the exact number of bytes first.
+///
+/// ASCII takes a vector fast path (SSE2 / AVX2 widening and narrowing of
+/// whole blocks). In a block with other characters, the ASCII prefix still
+/// goes through the vector path, the first other code point is converted
+/// alone, and the next block starts right after it.
+///
+/// Invalid input (truncated or overlong sequences, surrogates encoded in
+/// UTF-8, unpaired surrogates, code points above U+10FFFF) is rejected:
+/// transcode() throws std::invalid_argument with the offset of the faulty
+/// sequence, the kernels of StringKernels report it without throwing.
+///
+/// Example of usage:
+/// WString title = toWString(CStringView(utf8Buffer, utf8Size));
+/// CString bytes;
+/// transcode(title, bytes);   // reuses the capacity of bytes
+///=============================================================================
+namespace StringKernels
+{
+    ///=============================================================================
+    /// Outcome of a transcoding kernel: on failure, read is the offset of the
+    /// invalid sequence and written the number of characters produced before it.
+    ///=============================================================================
+    struct TranscodeResult
+    {
+        std::size_t read;
+        std::size_t written;
+        bool        valid;
+    };
+
+    //======================== ASCII block policies ================================
+    // nonAsciiBytes / nonAsciiUnits give one bit per character of a block of
+    // BLOCK characters, set for the characters of 0x80 and above. widen and
+    // narrow convert a whole block, the non-ASCII positions get garbage which
+    // the kernels overwrite.
+
+    /// Portable blocks of 8 characters.
+    struct ScalarAscii
+    {
+        static constexpr std::size_t BLOCK = 8;
+
+        static std::uint32_t nonAsciiBytes(const char* in) noexcept
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in, sizeof(word));
+            if ((word & 0x8080808080808080ull) == 0)
+            {
+                return 0;
+            }
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < BLOCK; ++i)
+            {
+                mask |= static_cast<std::uint32_t>(static_cast<unsigned char>(in[i]) >> 7) << i;
+            }
+            return mask;
+        }
+
+        template <typename WideT>
+        static void widen(const char* in, WideT* out) noexcept
+        {
+            for (std::size_t i = 0; i < BLOCK; ++i)
+            {
+                out[i] = static_cast<WideT>(static_cast<unsigned char>(in[i]));
+            }
+        }
+
+        template <typename WideT>
+        static std::uint32_t nonAsciiUnits(const WideT* in) noexcept
+        {
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < BLOCK; ++i)
+            {
+                mask |= static_cast<std::uint32_t>(charCode(in[i]) >= 0x80) << i;
+            }
+            return mask;
+        }
+
+        template <typename WideT>
+        static void narrow(const WideT* in, char* out) noexcept
+        {
+            for (std::size_t i = 0; i < BLOCK; ++i)
+            {
+                out[i] = static_cast<char>(in[i]);
+            }
+        }
+    };
+
+#if defined(USEFULCPP_SSE2)
+    /// SSE2: blocks of 16 characters.
+    struct Sse2Ascii
+    {
+        static constexpr std::size_t BLOCK = 16;
+
+        static std::uint32_t nonAsciiBytes(const char* in) noexcept
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))));
+        }
+
+        template <typename WideT>
+        static void widen(const char* in, WideT* out) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            __m128i* target = reinterpret_cast<__m128i*>(out);
+            if (sizeof(WideT) == 2)
+            {
+                _mm_storeu_si128(target, low);
+                _mm_storeu_si128(target + 1, high);
+            }
+            else
+            {
+                _mm_storeu_si128(target, _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(target + 1, _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(target + 2, _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(target + 3, _mm_unpackhi_epi16(high, zero));
+            }
+        }
+
+        template <typename WideT>
+        static std::uint32_t nonAsciiUnits(const WideT* in) noexcept
+        {
+            // All-ones per ASCII character, narrowed to a byte per character by
+            // the saturating packs, which keep 0 and -1
+            const __m128i* source = reinterpret_cast<const __m128i*>(in);
+            const __m128i zero = _mm_setzero_si128();
+            __m128i ascii;
+            if (sizeof(WideT) == 2)
+            {
+                const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+                ascii = _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(_mm_loadu_si128(source), high), zero),
+                                        _mm_cmpeq_epi16(_mm_and_si128(_mm_loadu_si128(source + 1), high), zero));
+            }
+            else
+            {
+                const __m128i high = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+                __m128i words[4];
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    words[i] = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(source + i), high), zero);
+                }
+                ascii = _mm_packs_epi16(_mm_packs_epi32(words[0], words[1]), _mm_packs_epi32(words[2], words[3]));
+            }
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(ascii)) ^ 0xFFFFu;
+        }
+
+        template <typename WideT>
+        static void narrow(const WideT* in, char* out) noexcept
+        {
+            const __m128i* source = reinterpret_cast<const __m128i*>(in);
+            __m128i bytes;
+            if (sizeof(WideT) == 2)
+            {
+                bytes = _mm_packus_epi16(_mm_loadu_si128(source), _mm_loadu_si128(source + 1));
+            }
+            else
+            {
+                bytes = _mm_packus_epi16(_mm_packs_epi32(_mm_loadu_si128(source), _mm_loadu_si128(source + 1)),
+                                         _mm_packs_epi32(_mm_loadu_si128(source + 2), _mm_loadu_si128(source + 3)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        }
+    };
+#endif // USEFULCPP_SSE2
+
+#if defined(USEFULCPP_X86)
+    /// AVX2: blocks of 32 characters. The packs work within 128-bit halves,
+    /// the permutes restore the order.
+    struct Avx2Ascii
+    {
+        static constexpr std::size_t BLOCK = 32;
+
+        USEFULCPP_TARGET_AVX2 static std::uint32_t nonAsciiBytes(const char* in) noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in))));
+        }
+
+        template <typename WideT>
+        USEFULCPP_TARGET_AVX2 static void widen(const char* in, WideT* out) noexcept
+        {
+            const __m128i* source = reinterpret_cast<const __m128i*>(in);
+            __m256i* target = reinterpret_cast<__m256i*>(out);
+            if (sizeof(WideT) == 2)
+            {
+                _mm256_storeu_si256(target, _mm256_cvtepu8_epi16(_mm_loadu_si128(source)));
+                _mm256_storeu_si256(target + 1, _mm256_cvtepu8_epi16(_mm_loadu_si128(source + 1)));
+            }
+            else
+            {
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + 8 * i));
+                    _mm256_storeu_si256(target + i, _mm256_cvtepu8_epi32(bytes));
+                }
+            }
+        }
+
+        template <typename WideT>
+        USEFULCPP_TARGET_AVX2 static std::uint32_t nonAsciiUnits(const WideT* in) noexcept
+        {
+            const __m256i* source = reinterpret_cast<const __m256i*>(in);
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i ascii;
+            if (sizeof(WideT) == 2)
+            {
+                const __m256i high = _mm256_set1_epi16(static_cast<short>(0xFF80));
+                if (_mm256_testz_si256(_mm256_or_si256(_mm256_loadu_si256(source), _mm256_loadu_si256(source + 1)), high))
+                {
+                    return 0; // all ASCII, the common case
+                }
+                ascii = _mm256_packs_epi16(_mm256_cmpeq_epi16(_mm256_and_si256(_mm256_loadu_si256(source), high), zero),
+                                           _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_loadu_si256(source + 1), high), zero));
+                ascii = _mm256_permute4x64_epi64(ascii, _MM_SHUFFLE(3, 1, 2, 0));
+            }
+            else
+            {
+                const __m256i high = _mm256_set1_epi32(static_cast<int>(0xFFFFFF80));
+                const __m256i bits = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256(source), _mm256_loadu_si256(source + 1)),
+                                                     _mm256_or_si256(_mm256_loadu_si256(source + 2), _mm256_loadu_si256(source + 3)));
+                if (_mm256_testz_si256(bits, high))
+                {
+                    return 0;
+                }
+                __m256i words[4];
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    words[i] = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(source + i), high), zero);
+                }
+                ascii = _mm256_packs_epi16(_mm256_packs_epi32(words[0], words[1]), _mm256_packs_epi32(words[2], words[3]));
+                ascii = _mm256_permutevar8x32_epi32(ascii, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            }
+            return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(ascii));
+        }
+
+        template <typename WideT>
+        USEFULCPP_TARGET_AVX2 static void narrow(const WideT* in, char* out) noexcept
+        {
+            const __m256i* source = reinterpret_cast<const __m256i*>(in);
+            __m256i bytes;
+            if (sizeof(WideT) == 2)
+            {
+                bytes = _mm256_packus_epi16(_mm256_loadu_si256(source), _mm256_loadu_si256(source + 1));
+                bytes = _mm256_permute4x64_epi64(bytes, _MM_SHUFFLE(3, 1, 2, 0));
+            }
+            else
+            {
+                bytes = _mm256_packus_epi16(_mm256_packs_epi32(_mm256_loadu_si256(source), _mm256_loadu_si256(source + 1)),
+                                            _mm256_packs_epi32(_mm256_loadu_si256(source + 2), _mm256_loadu_si256(source + 3)));
+                bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes);
+        }
+    };
+#endif // USEFULCPP_X86
+
+    //======================== Code points =========================================
+
+    ///=============================================================================
+    /// @brief Decodes a non-ASCII UTF-8 sequence.
+    ///
+    /// @param const unsigned char* p - first byte of the sequence.
+    /// @param const std::size_t available - bytes left in the input.
+    /// @param std::uint32_t& codePoint - receives the code point.
+    ///
+    /// @return std::size_t - length of the sequence, 0 if it is invalid.
+    ///=============================================================================
+    inline std::size_t decodeUtf8(const unsigned char* p,
+                                  const std::size_t available,
+                                  std::uint32_t& codePoint) noexcept
+    {
+        const std::uint32_t lead = p[0];
+        if (lead < 0xC2)
+        {
+            return 0; // continuation byte, or overlong 2-byte sequence
+        }
+        if (lead < 0xE0)
+        {
+            if (available < 2 || (p[1] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            codePoint = ((lead & 0x1F) << 6) | (p[1] & 0x3F);
+            return 2;
+        }
+        if (lead < 0xF0)
+        {
+            if (available < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            codePoint = ((lead & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+            return codePoint >= 0x800 && (codePoint < 0xD800 || codePoint > 0xDFFF) ? 3 : 0;
+        }
+        if (lead < 0xF5)
+        {
+            if (available < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            codePoint = ((lead & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+            return codePoint >= 0x10000 && codePoint <= 0x10FFFF ? 4 : 0;
+        }
+        return 0;
+    }
+
+    ///=============================================================================
+    /// @brief Encodes a valid code point as one or two (a surrogate pair, for
+    ///        2-byte characters) wide characters.
+    ///
+    /// @return std::size_t - number of characters written.
+    ///=============================================================================
+    template <typename WideT>
+    inline std::size_t encodeWide(std::uint32_t codePoint,
+                                  WideT* out) noexcept
+    {
+        if (sizeof(WideT) == 2 && codePoint >= 0x10000)
+        {
+            codePoint -= 0x10000;
+            out[0] = static_cast<WideT>(0xD800 + (codePoint >> 10));
+            out[1] = static_cast<WideT>(0xDC00 + (codePoint & 0x3FF));
+            return 2;
+        }
+        out[0] = static_cast<WideT>(codePoint);
+        return 1;
+    }
+
+    ///=============================================================================
+    /// @brief Encodes a valid code point of at least U+0800 in UTF-8.
+    ///
+    /// @return std::size_t - number of bytes written, 3 or 4.
+    ///=============================================================================
+    inline std::size_t encodeUtf8(const std::uint32_t codePoint,
+                                  char* out) noexcept
+    {
+        if (codePoint < 0x10000)
+        {
+            out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+            out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+        out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 4;
+    }
+
+    //======================== Generic kernels =====================================
+    // Every block is converted whole; the output index then only moves past
+    // its ASCII prefix, one code point is converted one at a time, and the
+    // next block starts right after it. The tail shorter than a block goes
+    // code point by code point.
+
+    ///=============================================================================
+    /// @brief Converts the non-ASCII UTF-8 sequence at in[i].
+    ///
+    /// @return true if the sequence is valid, i and written are moved past it.
+    ///=============================================================================
+    template <typename WideT>
+    inline bool utf8CodePointToWide(const unsigned char* in,
+                                    const std::size_t size,
+                                    std::size_t& i,
+                                    WideT* out,
+                                    std::size_t& written) noexcept
+    {
+        std::uint32_t codePoint = 0;
+        const std::size_t length = decodeUtf8(in + i, size - i, codePoint);
+        if (length == 0)
+        {
+            return false;
+        }
+        written += encodeWide(codePoint, out + written);
+        i += length;
+        return true;
+    }
+
+    ///=============================================================================
+    /// @brief Converts the non-ASCII wide character (or surrogate pair) at in[i].
+    ///
+    /// @return true if it is valid, i and written are moved past it.
+    ///=============================================================================
+    template <typename WideT>
+    inline bool wideCodePointToUtf8(const WideT* in,
+                                    const std::size_t size,
+                                    std::size_t& i,
+                                    char* out,
+                                    std::size_t& written) noexcept
+    {
+        std::uint32_t codePoint = charCode(in[i]);
+        if (codePoint < 0x800)
+        {
+            out[written++] = static_cast<char>(0xC0 | (codePoint >> 6));
+            out[written++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            ++i;
+            return true;
+        }
+        std::size_t units = 1;
+        if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+        {
+            // A high surrogate must be followed by a low one, in UTF-16 only
+            const std::uint32_t low = sizeof(WideT) == 2 && i + 1 < size ? charCode(in[i + 1]) : 0;
+            if (codePoint >= 0xDC00 || low < 0xDC00 || low > 0xDFFF)
+            {
+                return false;
+            }
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            units = 2;
+        }
+        else if (codePoint > 0x10FFFF)
+        {
+            return false;
+        }
+        written += encodeUtf8(codePoint, out + written);
+        i += units;
+        return true;
+    }
+
+    ///=============================================================================
+    /// @brief UTF-8 to UTF-16/32. out must have room for size characters.
+    ///=============================================================================
+    template <typename Ascii, typename WideT>
+    TranscodeResult utf8ToWideKernel(const char* in,
+                                     const std::size_t size,
+                                     WideT* out)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in);
+        std::size_t i = 0;
+        std::size_t written = 0;
+        while (i + Ascii::BLOCK <= size)
+        {
+            // written <= i, so the block fits the output
+            const std::uint32_t nonAscii = Ascii::nonAsciiBytes(in + i);
+            Ascii::widen(in + i, out + written);
+            if (nonAscii == 0)
+            {
+                i += Ascii::BLOCK;
+                written += Ascii::BLOCK;
+                continue;
+            }
+            const std::size_t prefix = lowestBit(nonAscii);
+            i += prefix;
+            written += prefix;
+            if (!utf8CodePointToWide(bytes, size, i, out, written))
+            {
+                return { i, written, false };
+            }
+        }
+        while (i < size)
+        {
+            if (bytes[i] < 0x80)
+            {
+                out[written++] = static_cast<WideT>(bytes[i++]);
+            }
+            else if (!utf8CodePointToWide(bytes, size, i, out, written))
+            {
+                return { i, written, false };
+            }
+        }
+        return { i, written, true };
+    }
+
+    ///=============================================================================
+    /// @brief UTF-16/32 to UTF-8. out must have room for utf8Length() bytes.
+    ///=============================================================================
+    template <typename Ascii, typename WideT>
+    TranscodeResult wideToUtf8Kernel(const WideT* in,
+                                     const std::size_t size,
+                                     char* out)
+    {
+        std::size_t i = 0;
+        std::size_t written = 0;
+        while (i + Ascii::BLOCK <= size)
+        {
+            // Every remaining character takes at least a byte, so the block fits the output
+            const std::uint32_t nonAscii = Ascii::nonAsciiUnits(in + i);
+            Ascii::narrow(in + i, out + written);
+            if (nonAscii == 0)
+            {
+                i += Ascii::BLOCK;
+                written += Ascii::BLOCK;
+                continue;
+            }
+            const std::size_t prefix = lowestBit(nonAscii);
+            i += prefix;
+            written += prefix;
+            if (!wideCodePointToUtf8(in, size, i, out, written))
+            {
+                return { i, written, false };
+            }
+        }
+        while (i < size)
+        {
+            if (charCode(in[i]) < 0x80)
+            {
+                out[written++] = static_cast<char>(in[i++]);
+            }
+            else if (!wideCodePointToUtf8(in, size, i, out, written))
+            {
+                return { i, written, false };
+            }
+        }
+        return { i, written, true };
+    }
+
+    ///=============================================================================
+    /// @brief UTF-8 bytes of a wide character; each half of a surrogate pair
+    ///        counts 2 bytes of the 4-byte sequence.
+    ///=============================================================================
+    inline std::size_t utf8Bytes(const std::uint32_t codePoint) noexcept
+    {
+        return codePoint < 0x80 ? 1
+             : codePoint < 0x800 || (codePoint >= 0xD800 && codePoint <= 0xDFFF) ? 2
+             : codePoint < 0x10000 ? 3
+             : 4;
+    }
+
+    ///=============================================================================
+    /// @brief Number of UTF-8 bytes of valid UTF-16/32 characters.
+    ///=============================================================================
+    template <typename Ascii, typename WideT>
+    std::size_t utf8LengthKernel(const WideT* in,
+                                 const std::size_t size)
+    {
+        std::size_t i = 0;
+        std::size_t length = 0;
+        while (i + Ascii::BLOCK <= size)
+        {
+            const std::uint32_t nonAscii = Ascii::nonAsciiUnits(in + i);
+            if (nonAscii == 0)
+            {
+                i += Ascii::BLOCK;
+                length += Ascii::BLOCK;
+                continue;
+            }
+            const std::size_t prefix = lowestBit(nonAscii);
+            length += prefix + utf8Bytes(charCode(in[i + prefix]));
+            i += prefix + 1;
+        }
+        for (; i < size; ++i)
+        {
+            length += utf8Bytes(charCode(in[i]));
+        }
+        return length;
+    }
+
+#if defined(USEFULCPP_X86)
+    template <typename WideT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    TranscodeResult avx2Utf8ToWide(const char* in, const std::size_t size, WideT* out)
+    {
+        return utf8ToWideKernel<Avx2Ascii>(in, size, out);
+    }
+
+    template <typename WideT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    TranscodeResult avx2WideToUtf8(const WideT* in, const std::size_t size, char* out)
+    {
+        return wideToUtf8Kernel<Avx2Ascii>(in, size, out);
+    }
+
+    template <typename WideT>
+    USEFULCPP_TARGET_AVX2 USEFULCPP_FLATTEN
+    std::size_t avx2Utf8Length(const WideT* in, const std::size_t size)
+    {
+        return utf8LengthKernel<Avx2Ascii>(in, size);
+    }
+#endif // USEFULCPP_X86
+
+#if defined(USEFULCPP_SSE2)
+    using DefaultAscii = Sse2Ascii;
+#else
+    using DefaultAscii = ScalarAscii;
+#endif
+
+    //======================== Entry points ========================================
+
+    ///=============================================================================
+    /// @brief Transcodes UTF-8 to UTF-16 (2-byte WideT) or UTF-32 (4-byte WideT).
+    ///
+    /// @param const char* in - UTF-8 bytes.
+    /// @param const std::size_t size - number of bytes.
+    /// @param WideT* out - room for size characters.
+    ///
+    /// @return TranscodeResult - characters written, or where the input is invalid.
+    ///=============================================================================
+    template <typename WideT>
+    TranscodeResult utf8ToWide(const char* in,
+                               const std::size_t size,
+                               WideT* out)
+    {
+        static_assert(sizeof(WideT) == 2 || sizeof(WideT) == 4, "utf8ToWide: 2 or 4-byte characters only");
+#if defined(USEFULCPP_X86)
+        if (size >= Avx2Ascii::BLOCK && cpuSupportsAvx2())
+        {
+            return avx2Utf8ToWide(in, size, out);
+        }
+#endif
+        return utf8ToWideKernel<DefaultAscii>(in, size, out);
+    }
+
+    ///=============================================================================
+    /// @brief Transcodes UTF-16 (2-byte WideT) or UTF-32 (4-byte WideT) to UTF-8.
+    ///
+    /// @param const WideT* in - characters.
+    /// @param const std::size_t size - number of characters.
+    /// @param char* out - room for utf8Length(in, size) bytes.
+    ///
+    /// @return TranscodeResult - bytes written, or where the input is invalid.
+    ///=============================================================================
+    template <typename WideT>
+    TranscodeResult wideToUtf8(const WideT* in,
+                               const std::size_t size,
+                               char* out)
+    {
+        static_assert(sizeof(WideT) == 2 || sizeof(WideT) == 4, "wideToUtf8: 2 or 4-byte characters only");
+#if defined(USEFULCPP_X86)
+        if (size >= Avx2Ascii::BLOCK && cpuSupportsAvx2())
+        {
+            return avx2WideToUtf8(in, size, out);
+        }
+#endif
+        return wideToUtf8Kernel<DefaultAscii>(in, size, out);
+    }
+
+    ///=============================================================================
+    /// @brief Counts the UTF-8 bytes of UTF-16/32 characters. Exact for valid
+    ///        input, never less than what wideToUtf8 writes.
+    ///
+    /// @return std::size_t - number of bytes.
+    ///=============================================================================
+    template <typename WideT>
+    std::size_t utf8Length(const WideT* in,
+                           const std::size_t size)
+    {
+#if defined(USEFULCPP_X86)
+        if (size >= Avx2Ascii::BLOCK && cpuSupportsAvx2())
+        {
+            return avx2Utf8Length(in, size);
+        }
+#endif
+        return utf8LengthKernel<DefaultAscii>(in, size);
+    }
+}
+
+///=============================================================================
+/// @brief Transcodes UTF-8 into a WString, replacing its contents. The string
+///        is sized for one character per byte, shrink_to_fit() releases the
+///        excess for non-ASCII text.
+///
+/// @param const BasicStringView<char> utf8 - UTF-8 text.
+/// @param String<wchar_t, Allocator>& out - destination.
+///
+/// @return void.
+///=============================================================================
+template <typename Allocator>
+void transcode(const BasicStringView<char> utf8,
+               String<wchar_t, Allocator>& out)
+{
+    StringKernels::TranscodeResult result = {};
+    out.clear();
+    out.resize_and_overwrite(utf8.size(), [&utf8, &result](wchar_t* data, std::size_t)
+    {
+        result = StringKernels::utf8ToWide(utf8.data(), utf8.size(), data);
+        return result.written;
+    });
+    if (!result.valid)
+    {
+        out.clear();
+        throw std::invalid_argument("transcode: invalid UTF-8 at byte " + std::to_string(result.read));
+    }
+}
+
+///=============================================================================
+/// @brief Transcodes wide characters into a UTF-8 CString, replacing its
+///        contents. The exact size is counted first.
+///
+/// @param const BasicStringView<wchar_t> wide - wide text.
+/// @param String<char, Allocator>& out - destination.
+///
+/// @return void.
+///=============================================================================
+template <typename Allocator>
+void transcode(const BasicStringView<wchar_t> wide,
+               String<char, Allocator>& out)
+{
+    StringKernels::TranscodeResult result = {};
+    out.clear();
+    out.resize_and_overwrite(StringKernels::utf8Length(wide.data(), wide.size()), [&wide, &result](char* data, std::size_t)
+    {
+        result = StringKernels::wideToUtf8(wide.data(), wide.size(), data);
+        return result.written;
+    });
+    if (!result.valid)
+    {
+        out.clear();
+        throw std::invalid_argument("transcode: invalid wide character at index " + std::to_string(result.read));
+    }
+}
+
+///=============================================================================
+/// @brief Transcodes UTF-8 into a new WString.
+///=============================================================================
+inline WString toWString(const BasicStringView<char> utf8)
+{
+    WString wide;
+    transcode(utf8, wide);
+    return wide;
+}
+
+///=============================================================================
+/// @brief Transcodes wide characters into a new UTF-8 CString.
+///=============================================================================
+inline CString toCString(const BasicStringView<wchar_t> wide)
+{
+    CString utf8;
+    transcode(wide, utf8);
+    return utf8;
+}
+
+#endif // STRINGTRANSCODE_H
@@ -0,0 +1,442 @@
+#ifndef STRINGVIEW_H
+#define STRINGVIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>    // for std::char_traits
+
+#include "StringHash.h"
+#include "StringSearch.h"
+
+///=============================================================================
+/// Non-owning view of characters: a pointer and a length, copied by value.
+/// Slicing a view or passing it around never allocates nor copies characters,
+/// and nothing has to be null-terminated. String converts to a view
+/// implicitly, so functions which only read a string should take a view.
+///
+/// A view must not outlive the characters it refers to, and is invalidated
+/// by anything which reallocates the String it was taken from.
+///
+/// Example of usage:
+/// MappedFile file("access.log");
+/// CStringView text(static_cast<const char*>(file.data()), file.size());
+/// for (CStringView line : split(text, '\n'))
+/// {
+///     const std::size_t protocol = line.find(" HTTP/");
+///     if (protocol != CStringView::npos)
+///     {
+///         CStringView status = line.substr(protocol + 10, 3);   // no allocation
+///     }
+/// }
+///=============================================================================
+template <typename CharT>
+class BasicStringView
+{
+public:
+    using value_type = CharT;
+
+    // Returned by the searches when nothing is found
+    static constexpr std::size_t npos = StringKernels::NOT_FOUND;
+
+    ///=============================================================================
+    /// @brief Default constructor. Creates an empty view.
+    ///=============================================================================
+    constexpr BasicStringView() noexcept
+        : m_data(nullptr)
+        , m_size(0)
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor.
+    ///
+    /// @param const CharT* data - characters.
+    /// @param const std::size_t size - number of characters.
+    ///=============================================================================
+    constexpr BasicStringView(const CharT* data,
+                              const std::size_t size) noexcept
+        : m_data(data)
+        , m_size(size)
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. C-String is passed.
+    ///
+    /// @param const CharT* cstr - c-style string.
+    ///=============================================================================
+    BasicStringView(const CharT* cstr) noexcept
+        : m_data(cstr)
+        , m_size(std::char_traits<CharT>::length(cstr))
+    {}
+
+    //============================= Access =========================================
+
+    ///=============================================================================
+    ///=============================================================================
+    constexpr const CharT& operator[](const std::size_t index) const noexcept { return m_data[index]; }
+
+    ///=============================================================================
+    /// @brief Gets the character at the given position, with bounds checking.
+    ///=============================================================================
+    const CharT& at(const std::size_t index) const
+    {
+        if (index >= m_size) { throw std::out_of_range("BasicStringView::at"); }
+        return m_data[index];
+    }
+
+    ///=============================================================================
+    /// @brief Gets the characters, not null-terminated in general.
+    ///=============================================================================
+    constexpr const CharT* data() const noexcept { return m_data; }
+    constexpr const CharT* begin() const noexcept { return m_data; }
+    constexpr const CharT* end() const noexcept { return m_data + m_size; }
+
+    ///=============================================================================
+    ///=============================================================================
+    constexpr std::size_t size() const noexcept { return m_size; }
+    constexpr std::size_t length() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+
+    //============================= Slicing ========================================
+
+    ///=============================================================================
+    /// @brief Gets a view of up to count characters from pos.
+    ///
+    /// @param const std::size_t pos - first character, not greater than size().
+    /// @param const std::size_t count - number of characters, npos for the rest.
+    ///
+    /// @return BasicStringView - the slice.
+    ///=============================================================================
+    BasicStringView substr(const std::size_t pos = 0,
+                           const std::size_t count = npos) const
+    {
+        if (pos > m_size) { throw std::out_of_range("BasicStringView::substr"); }
+        const std::size_t rest = m_size - pos;
+        return BasicStringView(m_data + pos, count < rest ? count : rest);
+    }
+
+    ///=============================================================================
+    /// @brief Drops n characters from the beginning, n <= size().
+    ///
+    /// @return void.
+    ///=============================================================================
+    void remove_prefix(const std::size_t n) noexcept
+    {
+        m_data += n;
+        m_size -= n;
+    }
+
+    ///=============================================================================
+    /// @brief Drops n characters from the end, n <= size().
+    ///
+    /// @return void.
+    ///=============================================================================
+    void remove_suffix(const std::size_t n) noexcept
+    {
+        m_size -= n;
+    }
+
+    ///=============================================================================
+    /// @brief Checks whether the view begins with prefix.
+    ///=============================================================================
+    bool starts_with(const BasicStringView prefix) const
+    {
+        return prefix.m_size <= m_size &&
+               StringKernels::equal(m_data, prefix.m_size, prefix.m_data, prefix.m_size);
+    }
+
+    ///=============================================================================
+    /// @brief Checks whether the view ends with suffix.
+    ///=============================================================================
+    bool ends_with(const BasicStringView suffix) const
+    {
+        return suffix.m_size <= m_size &&
+               StringKernels::equal(m_data + m_size - suffix.m_size, suffix.m_size, suffix.m_data, suffix.m_size);
+    }
+
+    //======================== Comparison and searching ============================
+
+    ///=============================================================================
+    /// @brief Three-way lexicographical comparison.
+    ///
+    /// @return int - negative if this view goes first, 0 if equal, positive
+    ///               otherwise.
+    ///=============================================================================
+    int compare(const BasicStringView str) const
+    {
+        return StringKernels::compare(m_data, m_size, str.m_data, str.m_size);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of a character at or after pos.
+    ///=============================================================================
+    std::size_t find(const CharT c,
+                     const std::size_t pos = 0) const
+    {
+        return StringKernels::find(m_data, m_size, c, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first occurrence of a substring at or after pos.
+    ///=============================================================================
+    std::size_t find(const BasicStringView str,
+                     const std::size_t pos = 0) const
+    {
+        return StringKernels::find(m_data, m_size, str.m_data, str.m_size, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of a character at or before pos.
+    ///=============================================================================
+    std::size_t rfind(const CharT c,
+                      const std::size_t pos = npos) const
+    {
+        return StringKernels::rfind(m_data, m_size, c, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the last occurrence of a substring at or before pos.
+    ///=============================================================================
+    std::size_t rfind(const BasicStringView str,
+                      const std::size_t pos = npos) const
+    {
+        return StringKernels::rfind(m_data, m_size, str.m_data, str.m_size, pos);
+    }
+
+    ///=============================================================================
+    /// @brief Finds the first character at or after pos which is one of the
+    ///        characters of set.
+    ///=============================================================================
+    std::size_t find_first_of(const BasicStringView set,
+                              const std::size_t pos = 0) const
+    {
+        return StringKernels::findFirstOf(m_data, m_size, set.m_data, set.m_size, pos);
+    }
+
+    //======================== Comparison operators ================================
+    // Hidden friends: found only when one side is a view, the other side then
+    // converts (a String or a c-string). String == c-string does not get here.
+
+    friend bool operator==(const BasicStringView lhs, const BasicStringView rhs)
+    {
+        return StringKernels::equal(lhs.m_data, lhs.m_size, rhs.m_data, rhs.m_size);
+    }
+
+    friend bool operator!=(const BasicStringView lhs, const BasicStringView rhs) { return !(lhs == rhs); }
+    friend bool operator<(const BasicStringView lhs, const BasicStringView rhs) { return lhs.compare(rhs) < 0; }
+    friend bool operator>(const BasicStringView lhs, const BasicStringView rhs) { return lhs.compare(rhs) > 0; }
+    friend bool operator<=(const BasicStringView lhs, const BasicStringView rhs) { return lhs.compare(rhs) <= 0; }
+    friend bool operator>=(const BasicStringView lhs, const BasicStringView rhs) { return lhs.compare(rhs) >= 0; }
+
+private:
+    const CharT* m_data;
+    std::size_t  m_size;
+};
+
+using CStringView = BasicStringView<char>;
+using WStringView = BasicStringView<wchar_t>;
+
+///=============================================================================
+/// Hash of a view, equal to the hash of a String with the same characters.
+///=============================================================================
+namespace std
+{
+    template <typename CharT>
+    struct hash<BasicStringView<CharT>>
+    {
+        std::size_t operator()(const BasicStringView<CharT> view) const
+        {
+            return StringKernels::hash(view.data(), view.size());
+        }
+    };
+}
+
+///=============================================================================
+/// Lazy split of a view by a character or a substring: a range of the views
+/// between the delimiters, found one at a time while iterating. Empty tokens
+/// are kept, so "a,,b" gives "a", "" and "b", and n delimiters always give
+/// n + 1 tokens. An empty delimiter gives the whole text as the single token.
+///=============================================================================
+template <typename CharT>
+class StringSplit
+{
+public:
+    using View = BasicStringView<CharT>;
+
+    ///=============================================================================
+    /// Forward iterator over the tokens.
+    ///=============================================================================
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = View;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const View*;
+        using reference = const View&;
+
+        ///=============================================================================
+        /// @brief Constructor of the end iterator.
+        ///=============================================================================
+        Iterator() noexcept
+            : m_split(nullptr)
+            , m_last(true)
+            , m_end(true)
+        {}
+
+        ///=============================================================================
+        /// @brief Constructor of the iterator of the first token.
+        ///=============================================================================
+        explicit Iterator(const StringSplit* split)
+            : m_split(split)
+            , m_rest(split->m_text)
+            , m_last(false)
+            , m_end(false)
+        {
+            advance();
+        }
+
+        reference operator*() const noexcept { return m_token; }
+        pointer operator->() const noexcept { return &m_token; }
+
+        Iterator& operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            advance();
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept
+        {
+            return lhs.m_end == rhs.m_end &&
+                   (lhs.m_end || (lhs.m_token.data() == rhs.m_token.data() && lhs.m_last == rhs.m_last));
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept { return !(lhs == rhs); }
+
+    private:
+        ///=============================================================================
+        /// @brief Cuts the next token off the rest of the text.
+        ///=============================================================================
+        void advance()
+        {
+            if (m_last)
+            {
+                m_end = true;
+                return;
+            }
+            const std::size_t pos = m_split->findDelimiter(m_rest);
+            if (pos == View::npos)
+            {
+                m_token = m_rest;
+                m_last = true;
+            }
+            else
+            {
+                m_token = View(m_rest.data(), pos);
+                m_rest.remove_prefix(pos + m_split->delimiterSize());
+            }
+        }
+
+        const StringSplit* m_split;
+        View               m_rest;
+        View               m_token;
+        bool               m_last;    // m_token is the last one
+        bool               m_end;
+    };
+
+    ///=============================================================================
+    /// @brief Constructor. Splits by a substring.
+    ///
+    /// @param const View text - text to split.
+    /// @param const View delimiter - separator of the tokens.
+    ///=============================================================================
+    StringSplit(const View text,
+                const View delimiter) noexcept
+        : m_text(text)
+        , m_delimiter(delimiter)
+        , m_delimiterChar(CharT())
+        , m_singleChar(false)
+    {}
+
+    ///=============================================================================
+    /// @brief Constructor. Splits by a character.
+    ///
+    /// @param const View text - text to split.
+    /// @param const CharT delimiter - separator of the tokens.
+    ///=============================================================================
+    StringSplit(const View text,
+                const CharT delimiter) noexcept
+        : m_text(text)
+        , m_delimiterChar(delimiter)
+        , m_singleChar(true)
+    {}
+
+    ///=============================================================================
+    /// @brief Iterators over the tokens; they refer to the range, which must
+    ///        stay alive while they are used.
+    ///=============================================================================
+    Iterator begin() const { return Iterator(this); }
+    Iterator end() const noexcept { return Iterator(); }
+
+private:
+    ///=============================================================================
+    /// @brief Finds the first delimiter of text.
+    ///=============================================================================
+    std::size_t findDelimiter(const View text) const
+    {
+        if (m_singleChar)
+        {
+            return text.find(m_delimiterChar);
+        }
+        return m_delimiter.empty() ? View::npos : text.find(m_delimiter);
+    }
+
+    ///=============================================================================
+    /// @brief Gets the number of characters of the delimiter.
+    ///=============================================================================
+    std::size_t delimiterSize() const noexcept { return m_singleChar ? 1 : m_delimiter.size(); }
+
+    View  m_text;
+    View  m_delimiter;
+    CharT m_delimiterChar;
+    bool  m_singleChar;
+};
+
+///=============================================================================
+/// @brief Splits a view by a character.
+///
+/// @param const BasicStringView<CharT> text - text to split.
+/// @param const CharT delimiter - separator of the tokens.
+///
+/// @return StringSplit<CharT> - range of the tokens.
+///=============================================================================
+template <typename CharT>
+inline StringSplit<CharT> split(const BasicStringView<CharT> text,
+                                const CharT delimiter) noexcept
+{
+    return StringSplit<CharT>(text, delimiter);
+}
+
+///=============================================================================
+/// @brief Splits a view by a substring.
+///
+/// @param const BasicStringView<CharT> text - text to split.
+/// @param const BasicStringView<CharT> delimiter - separator of the tokens.
+///
+/// @return StringSplit<CharT> - range of the tokens.
+///=============================================================================
+template <typename CharT>
+inline StringSplit<CharT> split(const BasicStringView<CharT> text,
+                                const BasicStringView<CharT> delimiter) noexcept
+{
+    return StringSplit<CharT>(text, delimiter);
+}
+
+#endif // STRINGVIEW_H
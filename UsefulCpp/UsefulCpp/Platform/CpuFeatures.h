@@ -0,0 +1,92 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+///=============================================================================
+/// Instruction set checks shared by the SIMD kernels.
+///
+/// USEFULCPP_X86         - x86 target, <immintrin.h> is included.
+/// USEFULCPP_SSE2        - SSE2 may be used unconditionally (always on x64).
+/// USEFULCPP_TARGET_AVX2 - marks a function which may use AVX2 intrinsics; it
+///                         must only be called if cpuSupportsAvx2() is true.
+/// USEFULCPP_TARGET_SSE41 - same for SSE4.1 and cpuSupportsSse41().
+/// USEFULCPP_FLATTEN     - inlines everything the function calls, so that the
+///                         generic kernels it instantiates are compiled for its
+///                         target as well.
+///=============================================================================
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define USEFULCPP_X86
+    #include <immintrin.h>
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define USEFULCPP_SSE2
+    #endif
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define USEFULCPP_TARGET_AVX2
+        #define USEFULCPP_TARGET_SSE41
+        #define USEFULCPP_FLATTEN
+    #else
+        #define USEFULCPP_TARGET_AVX2 __attribute__((target("avx2")))
+        #define USEFULCPP_TARGET_SSE41 __attribute__((target("sse4.1")))
+        #define USEFULCPP_FLATTEN __attribute__((flatten))
+    #endif
+#endif
+
+///=============================================================================
+/// @brief Checks (once) whether the CPU and the OS support AVX2.
+///
+/// @return true if AVX2 kernels may be used.
+///=============================================================================
+inline bool cpuSupportsAvx2()
+{
+#if defined(USEFULCPP_X86) && defined(_MSC_VER)
+    static const bool supported = []
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return supported;
+#elif defined(USEFULCPP_X86)
+    static const bool supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+///=============================================================================
+/// @brief Checks (once) whether the CPU supports SSE4.1.
+///
+/// @return true if SSE4.1 kernels may be used.
+///=============================================================================
+inline bool cpuSupportsSse41()
+{
+#if defined(USEFULCPP_X86) && defined(_MSC_VER)
+    static const bool supported = []
+    {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 19)) != 0;
+    }();
+    return supported;
+#elif defined(USEFULCPP_X86)
+    static const bool supported = __builtin_cpu_supports("sse4.1") != 0;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+#endif // CPUFEATURES_H
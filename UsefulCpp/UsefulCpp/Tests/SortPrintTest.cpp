@@ -0,0 +1,89 @@
+///=============================================================================
+/// Output test of SortingCore::print(). Build it as its own executable; it
+/// includes a sorting header only (print() needs nothing else) and checks
+/// that the printed text is the one of std::cout << element << ' ' for every
+/// element, followed by a new line.
+///
+/// Usage:
+/// SortPrintTest
+///
+/// Prints one line per case and returns EXIT_FAILURE if any text differs.
+///=============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "..\Algorithms\QuickSort\QuickSort.h"
+
+namespace
+{
+    std::size_t g_failures = 0;
+
+    ///=============================================================================
+    /// @brief Text which the element by element std::cout loop printed.
+    ///=============================================================================
+    template <typename T>
+    std::string expectedText(const std::vector<T>& elements)
+    {
+        std::ostringstream text;
+        for (const T element : elements)
+        {
+            text << element << ' ';
+        }
+        text << '\n';
+        return text.str();
+    }
+
+    ///=============================================================================
+    /// @brief Sorts a copy of elements, prints it with std::cout redirected and
+    ///        compares the text.
+    ///=============================================================================
+    template <typename T>
+    void expectPrinted(const char* name,
+                       std::vector<T> elements)
+    {
+        QuickSort<T> sorter(elements);
+        sorter.sort();
+
+        std::ostringstream printed;
+        std::streambuf* const console = std::cout.rdbuf(printed.rdbuf());
+        sorter.print();
+        std::cout.rdbuf(console);
+
+        const bool passed = printed.str() == expectedText(elements);
+        std::cout << (passed ? "PASS " : "FAIL ") << name << std::endl;
+        if (!passed)
+        {
+            ++g_failures;
+        }
+    }
+}
+
+int main()
+{
+    expectPrinted("empty", std::vector<int>());
+    expectPrinted("int limits", std::vector<int>{ 5, -3, 0, std::numeric_limits<int>::max(),
+                                                  std::numeric_limits<int>::min() });
+    expectPrinted("char", std::vector<char>{ 'c', 'a', 'b' });
+    expectPrinted("signed char", std::vector<signed char>{ 'y', 'x' });
+    expectPrinted("unsigned char", std::vector<unsigned char>{ 'q', 'p' });
+    expectPrinted("short", std::vector<short>{ 300, -300, 7 });
+    expectPrinted("std::int64_t limits", std::vector<std::int64_t>{ std::numeric_limits<std::int64_t>::min(),
+                                                                    std::numeric_limits<std::int64_t>::max() });
+    expectPrinted("std::uint64_t limits", std::vector<std::uint64_t>{ 0, std::numeric_limits<std::uint64_t>::max() });
+
+    // More text than one chunk of print()
+    std::vector<int> many(20000);
+    for (std::size_t i = 0; i < many.size(); ++i)
+    {
+        many[i] = static_cast<int>(i * 2654435761u);
+    }
+    expectPrinted("many ints", many);
+
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,180 @@
+///=============================================================================
+/// Allocation-count test of the small-string optimization of String (see
+/// String.h). Build it as its own executable; it replaces the global operator
+/// new and checks that short CString/WString construction, copy, move,
+/// assignment and destruction never reach the heap.
+///
+/// Usage:
+/// StringAllocationTest
+///
+/// Prints one line per case and returns EXIT_FAILURE if any case allocated.
+///=============================================================================
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include "..\Patterns\String\String.h"
+
+namespace
+{
+    // Heap allocations made while counting is on
+    std::size_t g_allocations = 0;
+    bool        g_counting = false;
+
+    void* allocate(const std::size_t size)
+    {
+        if (g_counting)
+        {
+            ++g_allocations;
+        }
+        if (void* memory = std::malloc(size == 0 ? 1 : size))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); }
+    catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); }
+    catch (...) { return nullptr; }
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+///=============================================================================
+/// Runs the cases for one character type and counts the failed ones.
+///=============================================================================
+template <typename CharT>
+class SmallStringAllocationTest
+{
+public:
+    using StringType = String<CharT>;
+
+    explicit SmallStringAllocationTest(const char* typeName)
+        : m_typeName(typeName)
+        , m_failures(0)
+    {
+        // The longest string which still fits the object, and a shorter one
+        for (std::size_t i = 0; i < StringType::LOCAL_CAPACITY; ++i)
+        {
+            m_longest[i] = static_cast<CharT>('a' + i % 26);
+        }
+        m_longest[StringType::LOCAL_CAPACITY] = CharT();
+        m_short[0] = CharT('x');
+        m_short[1] = CharT('y');
+        m_short[2] = CharT();
+    }
+
+    ///=============================================================================
+    /// @brief Runs all the cases.
+    ///
+    /// @return std::size_t - number of failed cases.
+    ///=============================================================================
+    std::size_t run()
+    {
+        const CharT* longest = m_longest;
+        const CharT* shortest = m_short;
+
+        expectNoAllocations("default construct and destroy", [] { StringType str; });
+        expectNoAllocations("construct from character", [] { StringType str(CharT('z')); });
+        expectNoAllocations("construct from C-string", [longest] { StringType str(longest); });
+        expectNoAllocations("construct from view", [longest]
+        {
+            StringType str(BasicStringView<CharT>(longest, StringType::LOCAL_CAPACITY));
+        });
+        expectNoAllocations("copy construct", [longest]
+        {
+            const StringType source(longest);
+            StringType copy(source);
+        });
+        expectNoAllocations("move construct", [longest]
+        {
+            StringType source(longest);
+            StringType moved(std::move(source));
+        });
+        expectNoAllocations("copy assign", [longest, shortest]
+        {
+            const StringType source(longest);
+            StringType target(shortest);
+            target = source;
+        });
+        expectNoAllocations("move assign", [longest, shortest]
+        {
+            StringType source(longest);
+            StringType target(shortest);
+            target = std::move(source);
+        });
+        expectNoAllocations("append up to the local capacity", [shortest]
+        {
+            StringType str;
+            while (str.size() + 2 <= StringType::LOCAL_CAPACITY)
+            {
+                str += shortest;
+            }
+            while (str.size() < StringType::LOCAL_CAPACITY)
+            {
+                str.push_back(CharT('z'));
+            }
+        });
+        return m_failures;
+    }
+
+private:
+    template <typename Case>
+    void expectNoAllocations(const char* name,
+                             Case testCase)
+    {
+        g_allocations = 0;
+        g_counting = true;
+        testCase();
+        g_counting = false;
+
+        const bool passed = g_allocations == 0;
+        std::cout << (passed ? "PASS " : "FAIL ") << m_typeName << ": " << name;
+        if (!passed)
+        {
+            std::cout << " (" << g_allocations << " allocations)";
+            ++m_failures;
+        }
+        std::cout << std::endl;
+    }
+
+    const char* m_typeName;
+    std::size_t m_failures;
+    CharT       m_longest[StringType::LOCAL_CAPACITY + 1];
+    CharT       m_short[3];
+};
+
+int main()
+{
+    std::size_t failures = SmallStringAllocationTest<char>("CString").run();
+    failures += SmallStringAllocationTest<wchar_t>("WString").run();
+
+    // Sanity check of the counter itself: a long string must allocate
+    g_allocations = 0;
+    g_counting = true;
+    {
+        CString str(CString::LOCAL_CAPACITY + 1);
+    }
+    g_counting = false;
+    if (g_allocations == 0)
+    {
+        std::cout << "FAIL allocation counter does not see String allocations" << std::endl;
+        ++failures;
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}